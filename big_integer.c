@@ -7,14 +7,85 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <limits.h>
+#include <float.h>
 #include <string.h>
 #include <assert.h>
+#include <time.h>
+#include <pthread.h>
 #include "macros.h"
 #include "big_integer.h"
+#include "big_integer_internal.h"
 
 /*#define UINT_NUM_BITS		(sizeof(unsigned int) * 8)*/
 const int UINT_NUM_BITS =	(sizeof(unsigned int) * 8);
 
+/* odd primes below 256, grouped so that the product of each group fits in an unsigned int */
+#define SMALL_PRIMES_COUNT			53
+#define SMALL_PRIMES_GROUPS_COUNT	12
+#define SMALL_PRIMES_LIMIT			65536	/* 256 * 256, below it trial division is conclusive */
+#define PRIME_SIEVE_SIZE			2048	/* odd candidates sieved at once by next_prime */
+
+/* decimal conversion works on chunks of 9 digits, the largest power of 10 in a limb */
+#define DECIMAL_CHUNK_DIGITS		9
+#define DECIMAL_CHUNK				1000000000
+#define DECIMAL_MAX_CHUNKS			((UINT_NUM_BITS * BIG_INTEGER_DATA_MAX_SIZE) / 29 + 1)
+
+/* a failed check calls big_integer_fail, which aborts or records the error and returns 1 */
+#define BIG_INTEGER_CHECK( condition, status )				( (condition) && big_integer_fail( status ) )
+
+/* checks that every internal caller already guarantees. BIG_INTEGER_UNCHECKED builds drop
+   them, leaving only the checks made by the public functions */
+#ifdef BIG_INTEGER_UNCHECKED
+	#define BIG_INTEGER_INTERNAL_CHECK( condition, status )	( 0 )
+#else
+	#define BIG_INTEGER_INTERNAL_CHECK( condition, status )	BIG_INTEGER_CHECK( condition, status )
+#endif
+
+const unsigned int SMALL_PRIMES[SMALL_PRIMES_COUNT] = {
+	3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, 97,
+	101, 103, 107, 109, 113, 127, 131, 137, 139, 149, 151, 157, 163, 167, 173, 179, 181, 191,
+	193, 197, 199, 211, 223, 227, 229, 233, 239, 241, 251 };
+const unsigned int SMALL_PRIMES_PRODUCTS[SMALL_PRIMES_GROUPS_COUNT] = {
+	3234846615u, 95041567, 907383479, 4132280413u, 121330189, 257557397,
+	490995677, 842952707, 1314423991, 2125525169, 3073309843u, 251 };
+/* index of the first prime of each group in SMALL_PRIMES, plus the end */
+const int SMALL_PRIMES_GROUPS[SMALL_PRIMES_GROUPS_COUNT + 1] = {
+	0, 9, 14, 19, 24, 28, 32, 36, 40, 44, 48, 52, 53 };
+
+/* the error handling of each thread, see BigIntegerErrorMode */
+__thread BigIntegerErrorMode THREAD_ERROR_MODE = BIG_INTEGER_ERROR_ABORT;
+__thread BigIntegerStatus THREAD_LAST_ERROR = BIG_INTEGER_OK;
+__thread BigIntegerProgressFunc THREAD_PROGRESS = NULL;
+__thread void *THREAD_PROGRESS_CONTEXT = NULL;
+
+/* see big_integer_set_memory_functions */
+void *(*MEMORY_ALLOCATE)( size_t size ) = malloc;
+void (*MEMORY_FREE)( void *pointer ) = free;
+
+typedef struct BigIntegerErrorState
+{
+	BigIntegerErrorMode mode;
+	BigIntegerStatus lastError;
+} BigIntegerErrorState;
+
+/* the state of each thread, seeded on first use */
+__thread BigIntegerRandomState THREAD_RANDOM_STATE;
+__thread int THREAD_RANDOM_SEEDED = 0;
+unsigned long long THREAD_RANDOM_COUNTER = 0;
+
+typedef struct BigIntegerPrimeBatch
+{
+	const BigInteger *candidates;
+	int *results;
+	int count;
+	int rounds;
+	int first;
+	int step;
+	int *done;			/* candidates tested by all the threads */
+	int *cancelled;
+	int reports;		/* runs on the calling thread, which has the progress function */
+} BigIntegerPrimeBatch;
+
 
 /* PRIVATE FUNCTIONS DECLARATIONS */
 BigIntegerData big_integer_empty_data( );
@@ -23,13 +94,56 @@ BigInteger big_integer_create_internal( const char sign, const BigIntegerData da
 void big_integer_normalize( BigIntegerData *pBigIntData );
 void big_integer_normalize_from( BigIntegerData *pBigIntData, const int from );
 void big_integer_clear_trash_data( BigIntegerData *pBigIntData );
-void big_integer_report_overflow();
 int big_integer_compare_data( const BigIntegerData *pLeft, const BigIntegerData *pRight );
 int big_integer_compare_data_uint( const BigIntegerData *pBigIntData, unsigned int value );
 BigIntegerData big_integer_add_data( const BigIntegerData left, const BigIntegerData right );
 BigIntegerData big_integer_subtract_data( const BigIntegerData left, const BigIntegerData right );
-void big_integer_increment_data( BigIntegerData *pBigIntData, const unsigned int value );
 void big_integer_decrement_data( BigIntegerData *pBigIntData, const unsigned int value );
+BigIntegerData big_integer_mul_data_uint( const BigIntegerData data, const unsigned int value );
+unsigned int big_integer_divmod_data_uint( BigIntegerData *pBigIntData, const unsigned int divisor );
+unsigned int big_integer_udiv_2by1_preinv( unsigned int *pQuotient, const unsigned int high, const unsigned int low, const unsigned int divisor, const unsigned int inverse );
+BigInteger big_integer_create_quotient( const char sign, BigIntegerData data );
+BigIntegerData big_integer_create_data_from_product( const unsigned int product[], const int length );
+BigIntegerData big_integer_multiply_data( const BigIntegerData left, const BigIntegerData right );
+BigIntegerData big_integer_square_data( const BigIntegerData data );
+int big_integer_power_of_two_data( const BigIntegerData *pBigIntData );
+int big_integer_compare_limbs( const unsigned int left[], const unsigned int right[], const int length );
+int big_integer_is_zero_limbs( const unsigned int bits[], const int length );
+int big_integer_bit_length_limbs( const unsigned int bits[], const int length );
+unsigned int big_integer_add_limbs( unsigned int result[], const unsigned int left[], const unsigned int right[], const int length );
+unsigned int big_integer_subtract_limbs( unsigned int result[], const unsigned int left[], const unsigned int right[], const int length );
+void big_integer_shift_right_limbs( unsigned int result[], const unsigned int bits[], const int length, const int shift );
+void big_integer_montgomery_init( BigIntegerModContext *pMont, const BigIntegerData *pModulus );
+void big_integer_montgomery_multiply( const BigIntegerModContext *pMont, unsigned int result[], const unsigned int left[], const unsigned int right[] );
+void big_integer_montgomery_add( const BigIntegerModContext *pMont, unsigned int result[], const unsigned int left[], const unsigned int right[] );
+void big_integer_montgomery_subtract( const BigIntegerModContext *pMont, unsigned int result[], const unsigned int left[], const unsigned int right[] );
+void big_integer_montgomery_half( const BigIntegerModContext *pMont, unsigned int result[], const unsigned int value[] );
+void big_integer_montgomery_from_int( const BigIntegerModContext *pMont, unsigned int result[], const int value );
+void big_integer_montgomery_power( const BigIntegerModContext *pMont, unsigned int result[], const unsigned int base[], const unsigned int exponent[], const int exponentLength );
+int big_integer_montgomery_inverse( const BigIntegerModContext *pMont, unsigned int result[], const unsigned int value[] );
+int big_integer_mod_load( const BigIntegerModContext *context, unsigned int result[], const BigInteger value );
+BigInteger big_integer_mod_store( const BigIntegerModContext *context, const unsigned int bits[] );
+unsigned int big_integer_gcd_uint( unsigned int left, unsigned int right );
+int big_integer_jacobi_uint( unsigned int value, unsigned int modulus );
+int big_integer_jacobi_data( int value, const BigIntegerData *pModulus );
+int big_integer_is_square_data( const BigIntegerData *pBigIntData );
+int big_integer_trial_division_data( const BigIntegerData *pBigIntData );
+int big_integer_strong_probable_prime( const BigIntegerModContext *pMont, const unsigned int base );
+int big_integer_strong_probable_prime_limbs( const BigIntegerModContext *pMont, const unsigned int base[] );
+int big_integer_strong_lucas_probable_prime( const BigIntegerModContext *pMont );
+int big_integer_probable_prime_data( const BigIntegerData *pBigIntData, const int rounds );
+void *big_integer_probable_prime_worker( void *pBatch );
+unsigned long long big_integer_splitmix64( unsigned long long *pState );
+unsigned long long big_integer_rotl64( const unsigned long long value, const int shift );
+BigIntegerData big_integer_random_data( BigIntegerRandomState *state, const int numBits );
+int big_integer_write_file_func( const char *digits, const int length, void *file );
+int big_integer_round_data( const BigIntegerData *pBigIntData, const int precision, unsigned int mantissa[], int *pLength );
+long double big_integer_round_to_floating( const BigInteger bigInt, const int precision, int *pExponent, int *pNumBits );
+long double big_integer_scale_long_double( long double value, int exponent );
+BigIntegerErrorState big_integer_begin_checked( );
+BigIntegerStatus big_integer_end_checked( const BigIntegerErrorState saved );
+BigIntegerDivisor big_integer_create_divisor_internal( const unsigned int divisor );
+int big_integer_cancellation_point( const double progress );
 
 
 /* PRIVATE FUNCTIONS IMPLEMENTATION */
@@ -43,12 +157,8 @@ BigIntegerData big_integer_empty_data( )
 
 BigIntegerData big_integer_create_data( const unsigned int bits[], const int length )
 {
-	if ( length > BIG_INTEGER_DATA_MAX_SIZE )
-	{
-		big_integer_report_overflow();
-		abort();
-		exit( EXIT_FAILURE );
-	}
+	if ( BIG_INTEGER_INTERNAL_CHECK( length > BIG_INTEGER_DATA_MAX_SIZE, BIG_INTEGER_OVERFLOW ) )
+		return big_integer_empty_data( );
 
 	BigIntegerData bigIntData;
 	if (bits && length > 0)
@@ -63,7 +173,8 @@ BigIntegerData big_integer_create_data( const unsigned int bits[], const int len
 BigInteger big_integer_create_internal( const char sign, const BigIntegerData data )
 {
 	BigInteger bigInt;
-	bigInt.sign = sign;
+	/* failed operations return empty data, which is zero */
+	bigInt.sign = ( data.length > 0 ) ? sign : 0;
 	bigInt.data = data;
 
 	return bigInt;
@@ -94,11 +205,6 @@ void big_integer_clear_trash_data( BigIntegerData *pBigIntData )
 		pBigIntData->bits[i] = 0;
 };
 
-void big_integer_report_overflow()
-{
-	fprintf(stderr, "BigInteger reported overflow!\n");
-};
-
 int big_integer_compare_data( const BigIntegerData *pLeft, const BigIntegerData *pRight )
 {
 	/* if the lengths are different */
@@ -154,6 +260,8 @@ BigIntegerData big_integer_add_data( const BigIntegerData left, const BigInteger
 
 	if ( sum > 0 )
 	{
+		if ( BIG_INTEGER_CHECK( i >= BIG_INTEGER_DATA_MAX_SIZE, BIG_INTEGER_OVERFLOW ) )
+			return big_integer_empty_data( );
 		result.bits[i] = (unsigned int) sum;
 		i++;
 	}
@@ -186,7 +294,7 @@ BigIntegerData big_integer_subtract_data( const BigIntegerData left, const BigIn
 		borrow = (borrow >> UINT_NUM_BITS) & 1; 
 	}
 
-	big_integer_normalize_from( &result, i );
+	big_integer_normalize_from( &result, len - 1 );
 
 	return result;
 };
@@ -197,6 +305,12 @@ void big_integer_increment_data( BigIntegerData *pBigIntData, const unsigned int
 	int i = 0;
 	while ( carry > 0 )
 	{
+		if ( BIG_INTEGER_CHECK( i >= BIG_INTEGER_DATA_MAX_SIZE, BIG_INTEGER_OVERFLOW ) )
+		{
+			*pBigIntData = big_integer_empty_data( );
+			return;
+		}
+
 		carry += (unsigned long long) pBigIntData->bits[i];
 		pBigIntData->bits[i] = (unsigned int) carry;
 		carry >>= UINT_NUM_BITS;
@@ -220,225 +334,2141 @@ void big_integer_decrement_data( BigIntegerData *pBigIntData, const unsigned int
 		++i;
 	}
 
-	big_integer_normalize_from( pBigIntData, i );
+	/* only a borrow out of the top limb can shrink the number */
+	big_integer_normalize_from( pBigIntData, pBigIntData->length - 1 );
 };
 
-
-
-
-/* PUBLIC FUNCTIONS IMPLEMENTATION */
-BigInteger big_integer_create( long long value )
+BigIntegerData big_integer_mul_data_uint( const BigIntegerData data, const unsigned int value )
 {
-	BigInteger bigInt;
-	int numBits = UINT_NUM_BITS;
+	BigIntegerData result = big_integer_empty_data( );
 
-	if ( value == 0 )
+	unsigned long long carry = 0;
+	int i;
+	for ( i = 0; i < data.length; ++i )
 	{
-		bigInt.sign = 0;
-		bigInt.data.bits[0] = 0;
-		bigInt.data.length = 1;
+		carry += (unsigned long long) data.bits[i] * value;
+		result.bits[i] = (unsigned int) carry;
+		carry >>= UINT_NUM_BITS;
 	}
-	else
-	{
-		unsigned long long uValue;
-		if ( value < 0 )
-		{
-			bigInt.sign = -1;
-			uValue = (unsigned long long) -value;
-		}
-		else
-		{
-			bigInt.sign = 1;
-			uValue = (unsigned long long) value;
-		}
 
-		bigInt.data.length = 0;
-		while ( uValue > 0 )
-		{
-			bigInt.data.bits[bigInt.data.length++] = (unsigned int) uValue;
-			uValue >>= numBits;
-		}
+	if ( carry > 0 )
+	{
+		if ( BIG_INTEGER_CHECK( i >= BIG_INTEGER_DATA_MAX_SIZE, BIG_INTEGER_OVERFLOW ) )
+			return big_integer_empty_data( );
+		result.bits[i] = (unsigned int) carry;
+		i++;
 	}
 
-	big_integer_clear_trash_data( &bigInt.data );
+	result.length = i;
 
-	return bigInt;
+	return result;
 };
 
-int big_integer_to_int( const BigInteger bigInt )
+/* divides pBigIntData in place and returns the remainder. divisor != 0 */
+unsigned int big_integer_divmod_data_uint( BigIntegerData *pBigIntData, const unsigned int divisor )
 {
-	if ( bigInt.sign == 0 )
+	if ( BIG_INTEGER_INTERNAL_CHECK( divisor == 0, BIG_INTEGER_DIVISION_BY_ZERO ) )
 		return 0;
 
-	/* overflow check */
-	if ( bigInt.data.length > 1 ||
-		(bigInt.sign == 1 && bigInt.data.bits[0] > INT_MAX) ||
-		(bigInt.sign == -1 && -(bigInt.data.bits[0]) < INT_MIN) )		
+	unsigned long long remainder = 0;
+	int i;
+	for ( i = pBigIntData->length - 1; i >= 0; --i )
 	{
-		big_integer_report_overflow();
-		abort();
-		exit( EXIT_FAILURE );
+		remainder = (remainder << UINT_NUM_BITS) | pBigIntData->bits[i];
+		pBigIntData->bits[i] = (unsigned int) (remainder / divisor);
+		remainder %= divisor;
 	}
 
-	if ( bigInt.sign == -1 )
-		return -(int)bigInt.data.bits[0];
-
-	return (int)bigInt.data.bits[0];
+	return (unsigned int) remainder;
 };
 
-long long big_integer_to_long_long( const BigInteger bigInt )
+/* divides ( high * 2^32 + low ) by divisor, given high < divisor, divisor normalized and
+   inverse = floor( (2^64 - 1) / divisor ) - 2^32. returns the remainder.
+   Moller & Granlund, "Improved division by invariant integers", algorithm 4 */
+unsigned int big_integer_udiv_2by1_preinv( unsigned int *pQuotient, const unsigned int high, const unsigned int low, const unsigned int divisor, const unsigned int inverse )
 {
-	if ( bigInt.sign == 0 )
-		return 0;
+	/* (inverse + 2^32) * high + low < 2^64 because high < divisor, so this can't overflow */
+	unsigned long long product = (unsigned long long) inverse * high + (((unsigned long long) high << UINT_NUM_BITS) | low);
 
-	int uIntNumBits = UINT_NUM_BITS;
-	int maxLength = sizeof(long long) / sizeof(unsigned int);
+	unsigned int quotient = (unsigned int) (product >> UINT_NUM_BITS) + 1;
+	unsigned int remainder = low - quotient * divisor;
 
-	if ( bigInt.data.length > maxLength )
+	if ( remainder > (unsigned int) product )
 	{
-		big_integer_report_overflow();
-		abort();
-		exit( EXIT_FAILURE );
+		--quotient;
+		remainder += divisor;
+	}
+	if ( remainder >= divisor ) /* unlikely */
+	{
+		++quotient;
+		remainder -= divisor;
 	}
 
-	unsigned long long result = 0;
-	int i = 0;
-	for ( i = 0; i < bigInt.data.length; ++i )
+	*pQuotient = quotient;
+	return remainder;
+};
+
+/* divides pBigIntData in place and returns the remainder */
+unsigned int big_integer_divmod_data_preinv( BigIntegerData *pBigIntData, const BigIntegerDivisor *pDivisor )
+{
+	int shift = pDivisor->shift;
+	int length = pBigIntData->length;
+	if ( length == 0 )
+		return 0;
+
+	/* the dividend is shifted by the same amount as the divisor, which doesn't change
+	   the quotient. the bits shifted out of the top limb are the first partial remainder,
+	   and they are always less than the normalized divisor. */
+	unsigned int remainder = 0;
+	if ( shift > 0 )
+		remainder = pBigIntData->bits[length-1] >> (UINT_NUM_BITS - shift);
+
+	int i;
+	for ( i = length - 1; i >= 0; --i )
 	{
-		result |= ((unsigned long long)bigInt.data.bits[i]) << (uIntNumBits * i);
+		unsigned int low = pBigIntData->bits[i] << shift;
+		if ( shift > 0 && i > 0 )
+			low |= pBigIntData->bits[i-1] >> (UINT_NUM_BITS - shift);
+
+		remainder = big_integer_udiv_2by1_preinv( &pBigIntData->bits[i], remainder, low,
+			pDivisor->normalized, pDivisor->inverse );
 	}
 
-	if ( bigInt.sign == -1 )
-		return -(long long)result;
+	return remainder >> shift;
+};
 
-	return result;
+/* builds a BigInteger from the (not normalized) quotient of a division */
+BigInteger big_integer_create_quotient( const char sign, BigIntegerData data )
+{
+	int from = data.length - 1;
+	data.length = 0;
+	big_integer_normalize_from( &data, from );
+
+	if ( data.length == 0 )
+		return big_integer_create( 0 );
+
+	return big_integer_create_internal( sign, data );
 };
 
-int big_integer_compare( const BigInteger left, const BigInteger right )
+/* builds the data from a double length product, reporting overflow if it doesn't fit */
+BigIntegerData big_integer_create_data_from_product( const unsigned int product[], const int length )
 {
-	/* if one is positive and the other negative */
-	if ( left.sign > right.sign )
-		return 1;
-	if ( left.sign < right.sign )
-		return -1;
-	
-	/* if they have the same sign */
-	char sign = left.sign;
-	return sign * big_integer_compare_data( &left.data, &right.data );
+	int len = length;
+	while ( len > 1 && product[len-1] == 0 )
+		--len;
+
+	if ( BIG_INTEGER_CHECK( len > BIG_INTEGER_DATA_MAX_SIZE, BIG_INTEGER_OVERFLOW ) )
+		return big_integer_empty_data( );
+
+	return big_integer_create_data( product, len );
 };
 
-BigInteger big_integer_add( const BigInteger left, const BigInteger right )
+BigIntegerData big_integer_multiply_data( const BigIntegerData left, const BigIntegerData right )
 {
-	if ( left.sign == 0 )
-		return right;
-	if ( right.sign == 0 )
-		return left;
+	unsigned int product[2 * BIG_INTEGER_DATA_MAX_SIZE];
+	memset( product, 0, sizeof(product) );
 
-	if ( left.sign == right.sign )
-		return big_integer_create_internal( left.sign, big_integer_add_data( left.data, right.data ));
+	int i, j;
+	for ( i = 0; i < left.length; ++i )
+	{
+		/* a * b + product + carry <= (2^32 - 1)^2 + 2 * (2^32 - 1) = 2^64 - 1 */
+		unsigned long long carry = 0;
+		for ( j = 0; j < right.length; ++j )
+		{
+			carry += (unsigned long long) left.bits[i] * right.bits[j] + product[i+j];
+			product[i+j] = (unsigned int) carry;
+			carry >>= UINT_NUM_BITS;
+		}
+		product[i+right.length] = (unsigned int) carry;
+	}
 
-	/* compare the MOD of the numbers */
-	int compRes = big_integer_compare_data( &left.data, &right.data );
+	return big_integer_create_data_from_product( product, left.length + right.length );
+};
 
-	if ( compRes == 0 )
-		return big_integer_create( 0 );
+BigIntegerData big_integer_square_data( const BigIntegerData data )
+{
+	unsigned int product[2 * BIG_INTEGER_DATA_MAX_SIZE];
+	memset( product, 0, sizeof(product) );
 
-	if ( compRes > 0 ) /* left > right */
-		return big_integer_create_internal( left.sign, big_integer_subtract_data( left.data, right.data ));
+	int length = data.length;
+	int i, j;
 
-	return big_integer_create_internal( right.sign, big_integer_subtract_data( right.data, left.data ));
+	/* each cross product a[i] * a[j] ( i < j ) appears twice in the square, 
+	   so it is computed only once and the sum is doubled afterwards */
+	for ( i = 0; i < length; ++i )
+	{
+		unsigned long long carry = 0;
+		for ( j = i + 1; j < length; ++j )
+		{
+			carry += (unsigned long long) data.bits[i] * data.bits[j] + product[i+j];
+			product[i+j] = (unsigned int) carry;
+			carry >>= UINT_NUM_BITS;
+		}
+		product[i+length] = (unsigned int) carry;
+	}
+
+	for ( i = 2 * length - 1; i > 0; --i )
+		product[i] = (product[i] << 1) | (product[i-1] >> (UINT_NUM_BITS - 1));
+	product[0] <<= 1;
+
+	/* adds the diagonal a[i] * a[i] */
+	unsigned long long carry = 0;
+	for ( i = 0; i < length; ++i )
+	{
+		unsigned long long square = (unsigned long long) data.bits[i] * data.bits[i];
+
+		carry += (square & UINT_MAX) + product[2*i];
+		product[2*i] = (unsigned int) carry;
+		carry >>= UINT_NUM_BITS;
+
+		carry += (square >> UINT_NUM_BITS) + product[2*i+1];
+		product[2*i+1] = (unsigned int) carry;
+		carry >>= UINT_NUM_BITS;
+	}
+
+	return big_integer_create_data_from_product( product, 2 * length );
 };
 
-BigInteger big_integer_subtract( const BigInteger left, const BigInteger right )
+/* returns k if the data is 2^k, -1 otherwise */
+int big_integer_power_of_two_data( const BigIntegerData *pBigIntData )
 {
-	if ( left.sign == 0 )
-		return big_integer_create_internal( -right.sign, right.data );
-	if ( right.sign == 0 )
-		return left;
+	int length = pBigIntData->length;
+	if ( length == 0 )
+		return -1;
 
-	if ( left.sign != right.sign )
-		return big_integer_create_internal( left.sign, big_integer_add_data(left.data, right.data) );
+	int i;
+	for ( i = 0; i < length - 1; ++i )
+		if ( pBigIntData->bits[i] != 0 )
+			return -1;
 
-	/* compare the MOD of the numbers */
-	int compRes = big_integer_compare_data( &left.data, &right.data );
+	unsigned int top = pBigIntData->bits[length-1];
+	if ( top == 0 || (top & (top - 1)) != 0 )
+		return -1;
 
-	if ( compRes == 0 )
-		return big_integer_create( 0 );
+	int k = UINT_NUM_BITS * (length - 1);
+	while ( top > 1 )
+	{
+		top >>= 1;
+		++k;
+	}
 
-	if ( compRes > 0 ) /* left > right */
-		return big_integer_create_internal( left.sign, big_integer_subtract_data(left.data, right.data) );
+	return k;
+};
 
-	return big_integer_create_internal( -right.sign, big_integer_subtract_data(right.data, left.data) );
+int big_integer_compare_limbs( const unsigned int left[], const unsigned int right[], const int length )
+{
+	int i;
+	for ( i = length - 1; i >= 0; --i )
+	{
+		if ( left[i] > right[i] )
+			return 1;
+		if ( left[i] < right[i] )
+			return -1;
+	}
+
+	return 0;
 };
 
-void big_integer_increment( BigInteger *bigInt, const unsigned int value )
+int big_integer_is_zero_limbs( const unsigned int bits[], const int length )
 {
-	if ( bigInt->sign >= 0 ) /* bigInt >= 0 */
+	int i;
+	for ( i = 0; i < length; ++i )
+		if ( bits[i] != 0 )
+			return 0;
+
+	return 1;
+};
+
+int big_integer_bit_length_limbs( const unsigned int bits[], const int length )
+{
+	int i = length - 1;
+	while ( i >= 0 && bits[i] == 0 )
+		--i;
+	if ( i < 0 )
+		return 0;
+
+	int numBits = UINT_NUM_BITS * i;
+	unsigned int top = bits[i];
+	while ( top > 0 )
 	{
-		if ( bigInt->sign == 0 && value > 0 )
-			bigInt->sign = 1;
-		big_integer_increment_data( &bigInt->data, value );
+		top >>= 1;
+		++numBits;
 	}
-	else /* bigInt < 0 */
+
+	return numBits;
+};
+
+/* result = left + right, returns the carry. result may alias the operands */
+unsigned int big_integer_add_limbs( unsigned int result[], const unsigned int left[], const unsigned int right[], const int length )
+{
+	unsigned long long sum = 0;
+	int i;
+	for ( i = 0; i < length; ++i )
 	{
-		int compRes = big_integer_compare_data_uint( &bigInt->data, value );
+		sum += (unsigned long long) left[i] + right[i];
+		result[i] = (unsigned int) sum;
+		sum >>= UINT_NUM_BITS;
+	}
 
-		if ( compRes == 0 ) /* |bigInt| == |value| */
-		{
-			bigInt->sign = 0;
-			bigInt->data.length = 0;
-			big_integer_clear_trash_data( &bigInt->data );
-		}
-		else if ( compRes > 0 ) /* |bigInt| > |value| */
-		{
-			big_integer_decrement_data( &bigInt->data, value );
-		}
-		else /* |bigInt| < |value| */
-		{
-#ifdef DEBUG
-			/* |bigInt| < |value| implies that bigInt has length 1
-			   because value, if expressed as a BigInteger, would have length 1. */
-			assert( bigInt->data.length == 1 );
-#endif
-			bigInt->sign = 1;
-			bigInt->data.bits[0] = value - bigInt->data.bits[0];
-		}
+	return (unsigned int) sum;
+};
+
+/* result = left - right, returns the borrow. result may alias the operands */
+unsigned int big_integer_subtract_limbs( unsigned int result[], const unsigned int left[], const unsigned int right[], const int length )
+{
+	unsigned long long borrow = 0;
+	int i;
+	for ( i = 0; i < length; ++i )
+	{
+		borrow = (unsigned long long) left[i] - right[i] - borrow;
+		result[i] = (unsigned int) borrow;
+		borrow = (borrow >> UINT_NUM_BITS) & 1;
 	}
+
+	return (unsigned int) borrow;
 };
 
-void big_integer_decrement( BigInteger *bigInt, const unsigned int value )
+/* 0 <= shift < 32 * length. result may alias bits */
+void big_integer_shift_right_limbs( unsigned int result[], const unsigned int bits[], const int length, const int shift )
 {
-	if ( bigInt->sign <= 0 )/* bigInt <= 0 */
+	int limbShift = shift / UINT_NUM_BITS;
+	int bitShift = shift % UINT_NUM_BITS;
+	int i;
+	for ( i = 0; i < length - limbShift; ++i )
 	{
-		if ( bigInt->sign == 0 && value > 0 )
-			bigInt->sign = -1;
-		big_integer_increment_data( &bigInt->data, value );
+		result[i] = bits[i + limbShift] >> bitShift;
+		if ( bitShift > 0 && i + limbShift + 1 < length )
+			result[i] |= bits[i + limbShift + 1] << (UINT_NUM_BITS - bitShift);
 	}
-	else /* bigInt > 0 */
+	for ( ; i < length; ++i )
+		result[i] = 0;
+};
+
+/* the modulus must be odd and greater than 1 */
+void big_integer_montgomery_init( BigIntegerModContext *pMont, const BigIntegerData *pModulus )
+{
+	int length = pModulus->length;
+	pMont->modulus = *pModulus;
+
+	/* Newton's iteration doubles the correct low bits of the inverse at each step,
+	   and every odd number is its own inverse modulo 8 */
+	unsigned int inverse = pModulus->bits[0];
+	int i;
+	for ( i = 0; i < 4; ++i )
+		inverse *= 2 - pModulus->bits[0] * inverse;
+	pMont->inverse = -inverse;
+
+	/* R mod modulus and R^2 mod modulus by modular doubling, starting from 1 */
+	unsigned int value[BIG_INTEGER_DATA_MAX_SIZE];
+	memset( value, 0, sizeof(value) );
+	value[0] = 1;
+	for ( i = 0; i < 2 * UINT_NUM_BITS * length; ++i )
 	{
-		int compRes = big_integer_compare_data_uint( &bigInt->data, value );
+		big_integer_montgomery_add( pMont, value, value, value );
+		if ( i == UINT_NUM_BITS * length - 1 )
+			memcpy( pMont->one, value, sizeof(value) );
+	}
+	memcpy( pMont->rSquared, value, sizeof(value) );
+};
 
-		if ( compRes == 0 ) /* |bigInt| == |value| */
-		{
-			bigInt->sign = 0;
-			bigInt->data.length = 0;
-			big_integer_clear_trash_data( &bigInt->data );
-		}
-		else if ( compRes > 0 ) /* |bigInt| > |value| */
+/* result = left * right / R mod modulus (CIOS). result may alias the operands */
+void big_integer_montgomery_multiply( const BigIntegerModContext *pMont, unsigned int result[], const unsigned int left[], const unsigned int right[] )
+{
+	const unsigned int *modulus = pMont->modulus.bits;
+	int length = pMont->modulus.length;
+
+	unsigned int t[BIG_INTEGER_DATA_MAX_SIZE + 2];
+	memset( t, 0, sizeof(t) );
+
+	int i, j;
+	for ( i = 0; i < length; ++i )
+	{
+		unsigned long long carry = 0;
+		for ( j = 0; j < length; ++j )
 		{
-			big_integer_decrement_data( &bigInt->data, value );
+			carry += (unsigned long long) left[j] * right[i] + t[j];
+			t[j] = (unsigned int) carry;
+			carry >>= UINT_NUM_BITS;
 		}
-		else /* |bigInt| < |value| */
+		carry += t[length];
+		t[length] = (unsigned int) carry;
+		t[length+1] = (unsigned int) (carry >> UINT_NUM_BITS);
+
+		/* adds m * modulus, which makes t divisible by 2^32, and shifts one limb */
+		unsigned int m = t[0] * pMont->inverse;
+		carry = ((unsigned long long) m * modulus[0] + t[0]) >> UINT_NUM_BITS;
+		for ( j = 1; j < length; ++j )
 		{
-#ifdef DEBUG
-			/* |bigInt| < |value| implies that bigInt has length 1 or less 
-			   because value, if expressed as a BigInteger, would have length 1. */
-			assert( bigInt->data.length == 1 );
-#endif
-			bigInt->sign = -1;
-			bigInt->data.bits[0] = value - bigInt->data.bits[0];
+			carry += (unsigned long long) m * modulus[j] + t[j];
+			t[j-1] = (unsigned int) carry;
+			carry >>= UINT_NUM_BITS;
 		}
+		carry += t[length];
+		t[length-1] = (unsigned int) carry;
+		t[length] = t[length+1] + (unsigned int) (carry >> UINT_NUM_BITS);
 	}
+
+	/* t < 2 * modulus */
+	if ( t[length] != 0 || big_integer_compare_limbs( t, modulus, length ) >= 0 )
+		big_integer_subtract_limbs( t, t, modulus, length );
+
+	memcpy( result, t, sizeof(unsigned int) * length );
+};
+
+void big_integer_montgomery_add( const BigIntegerModContext *pMont, unsigned int result[], const unsigned int left[], const unsigned int right[] )
+{
+	int length = pMont->modulus.length;
+	unsigned int carry = big_integer_add_limbs( result, left, right, length );
+
+	if ( carry || big_integer_compare_limbs( result, pMont->modulus.bits, length ) >= 0 )
+		big_integer_subtract_limbs( result, result, pMont->modulus.bits, length );
+};
+
+void big_integer_montgomery_subtract( const BigIntegerModContext *pMont, unsigned int result[], const unsigned int left[], const unsigned int right[] )
+{
+	int length = pMont->modulus.length;
+	unsigned int borrow = big_integer_subtract_limbs( result, left, right, length );
+
+	if ( borrow )
+		big_integer_add_limbs( result, result, pMont->modulus.bits, length );
+};
+
+/* result = value / 2 mod modulus */
+void big_integer_montgomery_half( const BigIntegerModContext *pMont, unsigned int result[], const unsigned int value[] )
+{
+	int length = pMont->modulus.length;
+	unsigned int carry = 0;
+
+	if ( value[0] & 1 )
+		carry = big_integer_add_limbs( result, value, pMont->modulus.bits, length );
+	else if ( result != value )
+		memcpy( result, value, sizeof(unsigned int) * length );
+
+	big_integer_shift_right_limbs( result, result, length, 1 );
+	result[length-1] |= carry << (UINT_NUM_BITS - 1);
+};
+
+/* converts a small signed value ( |value| < modulus ) to the Montgomery representation */
+void big_integer_montgomery_from_int( const BigIntegerModContext *pMont, unsigned int result[], const int value )
+{
+	unsigned int bits[BIG_INTEGER_DATA_MAX_SIZE];
+	memset( bits, 0, sizeof(bits) );
+	bits[0] = (unsigned int) (value < 0 ? -value : value);
+
+	big_integer_montgomery_multiply( pMont, result, bits, pMont->rSquared );
+
+	if ( value < 0 && !big_integer_is_zero_limbs( result, pMont->modulus.length ) )
+		big_integer_subtract_limbs( result, pMont->modulus.bits, result, pMont->modulus.length );
+};
+
+/* left-to-right binary exponentiation. result may alias base */
+void big_integer_montgomery_power( const BigIntegerModContext *pMont, unsigned int result[], const unsigned int base[], const unsigned int exponent[], const int exponentLength )
+{
+	int length = pMont->modulus.length;
+	unsigned int power[BIG_INTEGER_DATA_MAX_SIZE];
+	memcpy( power, pMont->one, sizeof(power) );
+
+	int i;
+	for ( i = big_integer_bit_length_limbs( exponent, exponentLength ) - 1; i >= 0; --i )
+	{
+		big_integer_montgomery_multiply( pMont, power, power, power );
+		if ( (exponent[i / UINT_NUM_BITS] >> (i % UINT_NUM_BITS)) & 1 )
+			big_integer_montgomery_multiply( pMont, power, power, base );
+	}
+
+	memcpy( result, power, sizeof(unsigned int) * length );
+};
+
+/* result = value^-1 mod modulus by the binary extended gcd, on plain (not Montgomery) values.
+   returns 0, leaving result untouched, if value and the modulus aren't coprime */
+int big_integer_montgomery_inverse( const BigIntegerModContext *pMont, unsigned int result[], const unsigned int value[] )
+{
+	int length = pMont->modulus.length;
+	unsigned int a[BIG_INTEGER_DATA_MAX_SIZE], b[BIG_INTEGER_DATA_MAX_SIZE];
+	unsigned int c[BIG_INTEGER_DATA_MAX_SIZE], d[BIG_INTEGER_DATA_MAX_SIZE];
+	unsigned int *u = a, *v = b, *x1 = c, *x2 = d, *swap;
+
+	if ( length == 0 )
+		return 0;
+
+	memcpy( u, value, sizeof(unsigned int) * length );
+	memcpy( v, pMont->modulus.bits, sizeof(unsigned int) * length );
+	memset( c, 0, sizeof(c) );
+	memset( d, 0, sizeof(d) );
+	x1[0] = 1;
+
+	/* keeps x1 * value = u and x2 * value = v (mod modulus), with v odd, until u is zero */
+	while ( !big_integer_is_zero_limbs( u, length ) )
+	{
+		while ( (u[0] & 1) == 0 )
+		{
+			big_integer_shift_right_limbs( u, u, length, 1 );
+			big_integer_montgomery_half( pMont, x1, x1 );
+		}
+
+		if ( big_integer_compare_limbs( u, v, length ) < 0 )
+		{
+			swap = u; u = v; v = swap;
+			swap = x1; x1 = x2; x2 = swap;
+		}
+
+		big_integer_subtract_limbs( u, u, v, length );
+		big_integer_montgomery_subtract( pMont, x1, x1, x2 );
+	}
+
+	/* v is now gcd( value, modulus ) */
+	if ( v[0] != 1 || !big_integer_is_zero_limbs( v + 1, length - 1 ) )
+		return 0;
+
+	memcpy( result, x2, sizeof(unsigned int) * length );
+	return 1;
+};
+
+/* copies a value reduced modulo the context into modulus.length limbs. returns 0 after reporting
+   BIG_INTEGER_INVALID_ARGUMENT for a value out of [0, modulus) or the context of an invalid modulus */
+int big_integer_mod_load( const BigIntegerModContext *context, unsigned int result[], const BigInteger value )
+{
+	memset( result, 0, sizeof(unsigned int) * context->modulus.length );
+
+	if ( BIG_INTEGER_CHECK( context->modulus.length == 0, BIG_INTEGER_INVALID_ARGUMENT ) )
+		return 0;
+	if ( value.sign == 0 )
+		return 1;
+	if ( BIG_INTEGER_CHECK( value.sign < 0 || big_integer_compare_data( &value.data, &context->modulus ) >= 0, BIG_INTEGER_INVALID_ARGUMENT ) )
+		return 0;
+
+	memcpy( result, value.data.bits, sizeof(unsigned int) * value.data.length );
+	return 1;
+};
+
+BigInteger big_integer_mod_store( const BigIntegerModContext *context, const unsigned int bits[] )
+{
+	return big_integer_create_quotient( 1, big_integer_create_data( bits, context->modulus.length ) );
+};
+
+unsigned int big_integer_gcd_uint( unsigned int left, unsigned int right )
+{
+	if ( left == 0 )
+		return right;
+	if ( right == 0 )
+		return left;
+
+	/* binary gcd, no divisions */
+	int shift = 0;
+	while ( ((left | right) & 1) == 0 )
+	{
+		left >>= 1;
+		right >>= 1;
+		++shift;
+	}
+	while ( (left & 1) == 0 )
+		left >>= 1;
+
+	while ( right != 0 )
+	{
+		while ( (right & 1) == 0 )
+			right >>= 1;
+		if ( left > right )
+		{
+			unsigned int swap = left;
+			left = right;
+			right = swap;
+		}
+		right -= left;
+	}
+
+	return left << shift;
+};
+
+/* jacobi symbol ( value / modulus ), modulus odd */
+int big_integer_jacobi_uint( unsigned int value, unsigned int modulus )
+{
+	int result = 1;
+	value %= modulus;
+
+	while ( value != 0 )
+	{
+		while ( (value & 1) == 0 )
+		{
+			value >>= 1;
+			if ( (modulus & 7) == 3 || (modulus & 7) == 5 )
+				result = -result;
+		}
+
+		/* quadratic reciprocity */
+		unsigned int swap = value;
+		value = modulus;
+		modulus = swap;
+		if ( (value & 3) == 3 && (modulus & 3) == 3 )
+			result = -result;
+
+		value %= modulus;
+	}
+
+	return modulus == 1 ? result : 0;
+};
+
+/* jacobi symbol ( value / modulus ), value != 0, modulus odd */
+int big_integer_jacobi_data( int value, const BigIntegerData *pModulus )
+{
+	int result = 1;
+	unsigned int modulus8 = pModulus->bits[0] & 7;
+
+	if ( value < 0 )
+	{
+		value = -value;
+		if ( (modulus8 & 3) == 3 )
+			result = -result;
+	}
+	while ( (value & 1) == 0 )
+	{
+		value >>= 1;
+		if ( modulus8 == 3 || modulus8 == 5 )
+			result = -result;
+	}
+	if ( value == 1 )
+		return result;
+
+	/* quadratic reciprocity turns it into a single word symbol */
+	if ( (value & 3) == 3 && (modulus8 & 3) == 3 )
+		result = -result;
+
+	BigIntegerData quotient = *pModulus;
+	unsigned int remainder = big_integer_divmod_data_uint( &quotient, (unsigned int) value );
+
+	return result * big_integer_jacobi_uint( remainder, (unsigned int) value );
+};
+
+int big_integer_is_square_data( const BigIntegerData *pBigIntData )
+{
+	int numBits = big_integer_bit_length_limbs( pBigIntData->bits, pBigIntData->length );
+	if ( numBits == 0 )
+		return 1;
+
+	/* the root has half the bits, found from the top one by one */
+	int top = (numBits + 1) / 2 - 1;
+	BigIntegerData root = big_integer_empty_data( );
+	root.length = top / UINT_NUM_BITS + 1;
+
+	int i;
+	for ( i = top; i >= 0; --i )
+	{
+		root.bits[i / UINT_NUM_BITS] |= 1u << (i % UINT_NUM_BITS);
+
+		BigIntegerData square = big_integer_square_data( root );
+		int compRes = big_integer_compare_data( &square, pBigIntData );
+		if ( compRes == 0 )
+			return 1;
+		if ( compRes > 0 )
+			root.bits[i / UINT_NUM_BITS] &= ~(1u << (i % UINT_NUM_BITS));
+	}
+
+	return 0;
+};
+
+/* returns 1 if the data is a prime, 0 if it has a small factor and -1 if it has none */
+int big_integer_trial_division_data( const BigIntegerData *pBigIntData )
+{
+	int i;
+
+	if ( pBigIntData->length <= 1 && pBigIntData->bits[0] < SMALL_PRIMES_LIMIT )
+	{
+		unsigned int value = pBigIntData->bits[0];
+		if ( value < 2 )
+			return 0;
+		if ( value == 2 )
+			return 1;
+		if ( (value & 1) == 0 )
+			return 0;
+
+		for ( i = 0; i < SMALL_PRIMES_COUNT && SMALL_PRIMES[i] * SMALL_PRIMES[i] <= value; ++i )
+			if ( value % SMALL_PRIMES[i] == 0 )
+				return 0;
+
+		return 1;
+	}
+
+	if ( (pBigIntData->bits[0] & 1) == 0 )
+		return 0;
+
+	/* one reduction per group of primes, the gcd with the product finds any of them */
+	for ( i = 0; i < SMALL_PRIMES_GROUPS_COUNT; ++i )
+	{
+		BigIntegerDivisor divisor = big_integer_create_divisor_internal( SMALL_PRIMES_PRODUCTS[i] );
+		BigIntegerData quotient = *pBigIntData;
+		unsigned int remainder = big_integer_divmod_data_preinv( &quotient, &divisor );
+
+		if ( big_integer_gcd_uint( remainder, SMALL_PRIMES_PRODUCTS[i] ) != 1 )
+			return 0;
+	}
+
+	return -1;
+};
+
+/* Miller-Rabin round, base < modulus */
+int big_integer_strong_probable_prime( const BigIntegerModContext *pMont, const unsigned int base )
+{
+	unsigned int bits[BIG_INTEGER_DATA_MAX_SIZE];
+	memset( bits, 0, sizeof(bits) );
+	bits[0] = base;
+
+	return big_integer_strong_probable_prime_limbs( pMont, bits );
+};
+
+/* the same with a base of modulus.length limbs, less than the modulus */
+int big_integer_strong_probable_prime_limbs( const BigIntegerModContext *pMont, const unsigned int base[] )
+{
+	int length = pMont->modulus.length;
+	unsigned int exponent[BIG_INTEGER_DATA_MAX_SIZE];
+	unsigned int minusOne[BIG_INTEGER_DATA_MAX_SIZE];
+	unsigned int x[BIG_INTEGER_DATA_MAX_SIZE];
+
+	/* modulus - 1 = exponent * 2^s, exponent odd */
+	memcpy( exponent, pMont->modulus.bits, sizeof(exponent) );
+	exponent[0] -= 1;
+	int s = 0;
+	while ( ((exponent[s / UINT_NUM_BITS] >> (s % UINT_NUM_BITS)) & 1) == 0 )
+		++s;
+	big_integer_shift_right_limbs( exponent, exponent, length, s );
+
+	big_integer_subtract_limbs( minusOne, pMont->modulus.bits, pMont->one, length );
+
+	big_integer_montgomery_multiply( pMont, x, base, pMont->rSquared );
+	big_integer_montgomery_power( pMont, x, x, exponent, length );
+
+	if ( big_integer_compare_limbs( x, pMont->one, length ) == 0 ||
+		big_integer_compare_limbs( x, minusOne, length ) == 0 )
+		return 1;
+
+	int i;
+	for ( i = 1; i < s; ++i )
+	{
+		big_integer_montgomery_multiply( pMont, x, x, x );
+		if ( big_integer_compare_limbs( x, minusOne, length ) == 0 )
+			return 1;
+		if ( big_integer_compare_limbs( x, pMont->one, length ) == 0 )
+			return 0;
+	}
+
+	return 0;
+};
+
+/* strong Lucas probable prime test with Selfridge's parameters ( P = 1, Q = (1 - D) / 4 ).
+   the modulus must not have small factors */
+int big_integer_strong_lucas_probable_prime( const BigIntegerModContext *pMont )
+{
+	int length = pMont->modulus.length;
+
+	/* first D in 5, -7, 9, -11, ... with ( D / modulus ) = -1. 
+	   there is none if the modulus is a square, so that is ruled out along the way */
+	int d = 5;
+	int attempts;
+	for ( attempts = 0; ; ++attempts )
+	{
+		int jacobi = big_integer_jacobi_data( d, &pMont->modulus );
+		if ( jacobi == -1 )
+			break;
+		if ( jacobi == 0 ) /* modulus > |D|, so they share a factor */
+			return 0;
+		if ( attempts == 4 && big_integer_is_square_data( &pMont->modulus ) )
+			return 0;
+
+		d = ( d > 0 ) ? -(d + 2) : -d + 2;
+	}
+
+	unsigned int dMont[BIG_INTEGER_DATA_MAX_SIZE];
+	unsigned int qMont[BIG_INTEGER_DATA_MAX_SIZE];
+	big_integer_montgomery_from_int( pMont, dMont, d );
+	big_integer_montgomery_from_int( pMont, qMont, (1 - d) / 4 );
+
+	/* modulus + 1 = exponent * 2^s, exponent odd. modulus + 1 may need an extra limb */
+	unsigned int exponent[BIG_INTEGER_DATA_MAX_SIZE + 1];
+	unsigned int one[BIG_INTEGER_DATA_MAX_SIZE + 1];
+	memset( exponent, 0, sizeof(exponent) );
+	memset( one, 0, sizeof(one) );
+	one[0] = 1;
+	memcpy( exponent, pMont->modulus.bits, sizeof(unsigned int) * length );
+	big_integer_add_limbs( exponent, exponent, one, length + 1 );
+	int s = 0;
+	while ( ((exponent[s / UINT_NUM_BITS] >> (s % UINT_NUM_BITS)) & 1) == 0 )
+		++s;
+	big_integer_shift_right_limbs( exponent, exponent, length + 1, s );
+
+	/* U(1) = 1, V(1) = P = 1, Q^1 */
+	unsigned int u[BIG_INTEGER_DATA_MAX_SIZE];
+	unsigned int v[BIG_INTEGER_DATA_MAX_SIZE];
+	unsigned int qk[BIG_INTEGER_DATA_MAX_SIZE];
+	unsigned int t[BIG_INTEGER_DATA_MAX_SIZE];
+	memcpy( u, pMont->one, sizeof(u) );
+	memcpy( v, pMont->one, sizeof(v) );
+	memcpy( qk, qMont, sizeof(qk) );
+
+	int i;
+	for ( i = big_integer_bit_length_limbs( exponent, length ) - 2; i >= 0; --i )
+	{
+		/* U(2k) = U(k) V(k), V(2k) = V(k)^2 - 2 Q^k */
+		big_integer_montgomery_multiply( pMont, u, u, v );
+		big_integer_montgomery_add( pMont, t, qk, qk );
+		big_integer_montgomery_multiply( pMont, v, v, v );
+		big_integer_montgomery_subtract( pMont, v, v, t );
+		big_integer_montgomery_multiply( pMont, qk, qk, qk );
+
+		if ( (exponent[i / UINT_NUM_BITS] >> (i % UINT_NUM_BITS)) & 1 )
+		{
+			/* U(k+1) = ( P U(k) + V(k) ) / 2, V(k+1) = ( D U(k) + P V(k) ) / 2 */
+			big_integer_montgomery_multiply( pMont, t, dMont, u );
+			big_integer_montgomery_add( pMont, u, u, v );
+			big_integer_montgomery_half( pMont, u, u );
+			big_integer_montgomery_add( pMont, v, v, t );
+			big_integer_montgomery_half( pMont, v, v );
+			big_integer_montgomery_multiply( pMont, qk, qk, qMont );
+		}
+	}
+
+	if ( big_integer_is_zero_limbs( u, length ) || big_integer_is_zero_limbs( v, length ) )
+		return 1;
+
+	for ( i = 1; i < s; ++i )
+	{
+		big_integer_montgomery_add( pMont, t, qk, qk );
+		big_integer_montgomery_multiply( pMont, v, v, v );
+		big_integer_montgomery_subtract( pMont, v, v, t );
+		if ( big_integer_is_zero_limbs( v, length ) )
+			return 1;
+		big_integer_montgomery_multiply( pMont, qk, qk, qk );
+	}
+
+	return 0;
+};
+
+/* the data must be odd, above SMALL_PRIMES_LIMIT and without small factors */
+int big_integer_probable_prime_data( const BigIntegerData *pBigIntData, const int rounds )
+{
+	BigIntegerModContext mont;
+	big_integer_montgomery_init( &mont, pBigIntData );
+
+	if ( !big_integer_strong_probable_prime( &mont, 2 ) )
+		return 0;
+
+	if ( rounds <= 0 )
+		return big_integer_strong_lucas_probable_prime( &mont );
+
+	int i;
+	for ( i = 0; i < rounds - 1 && i < SMALL_PRIMES_COUNT; ++i )
+		if ( !big_integer_strong_probable_prime( &mont, SMALL_PRIMES[i] ) )
+			return 0;
+
+	/* once the small primes run out, the bases are random in [2, modulus - 2] */
+	BigIntegerRandomState *state = big_integer_random_thread_state( );
+	int numBits = big_integer_bit_length_limbs( pBigIntData->bits, pBigIntData->length );
+	BigIntegerData minusOne = *pBigIntData;
+	minusOne.bits[0] -= 1;
+
+	for ( ; i < rounds - 1; ++i )
+	{
+		BigIntegerData base;
+		do
+			base = big_integer_random_data( state, numBits );
+		while ( big_integer_compare_data_uint( &base, 2 ) < 0 || big_integer_compare_data( &base, &minusOne ) >= 0 );
+
+		if ( !big_integer_strong_probable_prime_limbs( &mont, base.bits ) )
+			return 0;
+	}
+
+	return 1;
+};
+
+void *big_integer_probable_prime_worker( void *pBatch )
+{
+	BigIntegerPrimeBatch *batch = (BigIntegerPrimeBatch *) pBatch;
+
+	int i;
+	for ( i = batch->first; i < batch->count; i += batch->step )
+	{
+		if ( __atomic_load_n( batch->cancelled, __ATOMIC_RELAXED ) )
+			break;
+
+		batch->results[i] = big_integer_is_probable_prime( batch->candidates[i], batch->rounds );
+
+		int done = __atomic_add_fetch( batch->done, 1, __ATOMIC_RELAXED );
+		if ( batch->reports && big_integer_cancellation_point( (double) done / batch->count ) )
+			__atomic_store_n( batch->cancelled, 1, __ATOMIC_RELAXED );
+	}
+
+	return NULL;
+};
+
+unsigned long long big_integer_splitmix64( unsigned long long *pState )
+{
+	unsigned long long z = (*pState += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+};
+
+unsigned long long big_integer_rotl64( const unsigned long long value, const int shift )
+{
+	return (value << shift) | (value >> (64 - shift));
+};
+
+/* fills the limbs straight from the generator, 0 <= numBits <= capacity */
+BigIntegerData big_integer_random_data( BigIntegerRandomState *state, const int numBits )
+{
+	BigIntegerData data = big_integer_empty_data( );
+	int length = (numBits + UINT_NUM_BITS - 1) / UINT_NUM_BITS;
+
+	int i;
+	for ( i = 0; i < length; i += 2 )
+	{
+		unsigned long long word = big_integer_random_next( state );
+		data.bits[i] = (unsigned int) word;
+		if ( i + 1 < length )
+			data.bits[i+1] = (unsigned int) (word >> UINT_NUM_BITS);
+	}
+
+	if ( numBits % UINT_NUM_BITS != 0 )
+		data.bits[length-1] &= (1u << (numBits % UINT_NUM_BITS)) - 1;
+
+	big_integer_normalize_from( &data, length - 1 );
+
+	return data;
+};
+
+int big_integer_write_file_func( const char *digits, const int length, void *file )
+{
+	return fwrite( digits, 1, (size_t) length, (FILE *) file ) != (size_t) length;
+};
+
+int big_integer_round_data( const BigIntegerData *pBigIntData, const int precision, unsigned int mantissa[], int *pLength )
+{
+	const unsigned int *bits = pBigIntData->bits;
+	int numBits = big_integer_bit_length_limbs( bits, pBigIntData->length );
+	int shift = MAX( numBits - precision, 0 );
+	int wordShift = shift / UINT_NUM_BITS;
+	int bitShift = shift % UINT_NUM_BITS;
+	int length = (numBits - shift + UINT_NUM_BITS - 1) / UINT_NUM_BITS;
+	int i;
+
+	/* only the limbs holding the top precision bits are read */
+	for ( i = 0; i < length; ++i )
+	{
+		mantissa[i] = bits[wordShift + i] >> bitShift;
+		if ( bitShift > 0 && wordShift + i + 1 < pBigIntData->length )
+			mantissa[i] |= bits[wordShift + i + 1] << (UINT_NUM_BITS - bitShift);
+	}
+
+	/* rounds to nearest, ties to even. the bits below the round bit are only
+	   looked at when they decide a tie */
+	if ( shift > 0 && ((bits[(shift - 1) / UINT_NUM_BITS] >> ((shift - 1) % UINT_NUM_BITS)) & 1) )
+	{
+		int roundUp = mantissa[0] & 1;
+		int sticky = (shift - 1) / UINT_NUM_BITS;
+		if ( !roundUp )
+		{
+			roundUp = (bits[sticky] & ((1u << ((shift - 1) % UINT_NUM_BITS)) - 1)) != 0;
+			for ( i = sticky - 1; i >= 0 && !roundUp; --i )
+				roundUp = bits[i] != 0;
+		}
+
+		if ( roundUp )
+		{
+			/* may carry to 2^precision, which is still exact */
+			for ( i = 0; i < length && ++mantissa[i] == 0; ++i )
+				;
+			if ( i == length )
+				mantissa[length++] = 1;
+		}
+	}
+
+	*pLength = length;
+	return shift;
+};
+
+long double big_integer_round_to_floating( const BigInteger bigInt, const int precision, int *pExponent, int *pNumBits )
+{
+	unsigned int mantissa[BIG_INTEGER_DATA_MAX_SIZE + 1];
+	long double result = 0;
+	int length, i;
+
+	*pExponent = big_integer_round_data( &bigInt.data, precision, mantissa, &length );
+	*pNumBits = big_integer_bit_length_limbs( mantissa, length );
+
+	/* the mantissa has at most precision bits, so every step is exact */
+	for ( i = length - 1; i >= 0; --i )
+		result = result * 4294967296.0L + mantissa[i];
+
+	return bigInt.sign < 0 ? -result : result;
+};
+
+long double big_integer_scale_long_double( long double value, int exponent )
+{
+	/* multiplies by 2^exponent. ldexpl isn't part of C89 */
+	while ( exponent >= UINT_NUM_BITS )
+	{
+		value *= 4294967296.0L;
+		exponent -= UINT_NUM_BITS;
+	}
+	while ( exponent <= -UINT_NUM_BITS )
+	{
+		value /= 4294967296.0L;
+		exponent += UINT_NUM_BITS;
+	}
+
+	if ( exponent > 0 )
+		value *= (long double) (1u << exponent);
+	else if ( exponent < 0 )
+		value /= (long double) (1u << -exponent);
+
+	return value;
+};
+
+int big_integer_fail( const BigIntegerStatus status )
+{
+	/* the first error is kept until it is cleared */
+	if ( THREAD_LAST_ERROR == BIG_INTEGER_OK )
+		THREAD_LAST_ERROR = status;
+
+	if ( THREAD_ERROR_MODE == BIG_INTEGER_ERROR_ABORT )
+	{
+		fprintf(stderr, "BigInteger reported %s!\n", big_integer_status_string( status ));
+		abort();
+		exit( EXIT_FAILURE );
+	}
+
+	return 1;
+};
+
+void *big_integer_allocate( const size_t size )
+{
+	void *pointer = MEMORY_ALLOCATE( size );
+	if ( !pointer )
+		big_integer_fail( BIG_INTEGER_OUT_OF_MEMORY );
+
+	return pointer;
+};
+
+void big_integer_free( void *pointer )
+{
+	MEMORY_FREE( pointer );
+};
+
+/* the checked functions run in flag mode without touching the caller's error state */
+BigIntegerErrorState big_integer_begin_checked( )
+{
+	BigIntegerErrorState saved;
+	saved.mode = THREAD_ERROR_MODE;
+	saved.lastError = THREAD_LAST_ERROR;
+
+	THREAD_ERROR_MODE = BIG_INTEGER_ERROR_FLAG;
+	THREAD_LAST_ERROR = BIG_INTEGER_OK;
+
+	return saved;
+};
+
+BigIntegerStatus big_integer_end_checked( const BigIntegerErrorState saved )
+{
+	BigIntegerStatus status = THREAD_LAST_ERROR;
+
+	THREAD_ERROR_MODE = saved.mode;
+	THREAD_LAST_ERROR = saved.lastError;
+
+	return status;
+};
+
+/* lets the progress function of the thread cancel the operation. a cancel was asked for,
+   so it is recorded but never aborts */
+int big_integer_cancellation_point( const double progress )
+{
+	if ( !THREAD_PROGRESS || THREAD_PROGRESS( progress, THREAD_PROGRESS_CONTEXT ) == 0 )
+		return 0;
+
+	if ( THREAD_LAST_ERROR == BIG_INTEGER_OK )
+		THREAD_LAST_ERROR = BIG_INTEGER_CANCELLED;
+
+	return 1;
+};
+
+BigIntegerDivisor big_integer_create_divisor_internal( const unsigned int divisor )
+{
+	BigIntegerDivisor result;
+	result.value = divisor;
+	result.shift = 0;
+	result.normalized = divisor;
+
+	if ( BIG_INTEGER_INTERNAL_CHECK( divisor == 0, BIG_INTEGER_DIVISION_BY_ZERO ) )
+		result.value = result.normalized = 1;
+
+	while ( (result.normalized & (1u << (UINT_NUM_BITS - 1))) == 0 )
+	{
+		result.normalized <<= 1;
+		result.shift++;
+	}
+
+	/* the only hardware division ever needed for this divisor */
+	result.inverse = (unsigned int) (~0ULL / result.normalized - (1ULL << UINT_NUM_BITS));
+
+	return result;
+};
+
+
+
+
+/* PUBLIC FUNCTIONS IMPLEMENTATION */
+BigInteger big_integer_create( long long value )
+{
+	BigInteger bigInt;
+	int numBits = UINT_NUM_BITS;
+
+	if ( value == 0 )
+	{
+		bigInt.sign = 0;
+		bigInt.data.bits[0] = 0;
+		bigInt.data.length = 1;
+	}
+	else
+	{
+		unsigned long long uValue;
+		if ( value < 0 )
+		{
+			bigInt.sign = -1;
+			uValue = -(unsigned long long) value;
+		}
+		else
+		{
+			bigInt.sign = 1;
+			uValue = (unsigned long long) value;
+		}
+
+		bigInt.data.length = 0;
+		while ( uValue > 0 )
+		{
+			bigInt.data.bits[bigInt.data.length++] = (unsigned int) uValue;
+			uValue >>= numBits;
+		}
+	}
+
+	big_integer_clear_trash_data( &bigInt.data );
+
+	return bigInt;
+};
+
+int big_integer_to_int( const BigInteger bigInt )
+{
+	if ( bigInt.sign == 0 )
+		return 0;
+
+	/* overflow check */
+	if ( BIG_INTEGER_CHECK( bigInt.data.length > 1 ||
+		(bigInt.sign == 1 && bigInt.data.bits[0] > INT_MAX) ||
+		(bigInt.sign == -1 && -(bigInt.data.bits[0]) < INT_MIN), BIG_INTEGER_OVERFLOW ) )
+		return 0;
+
+	/* written so that INT_MIN doesn't overflow */
+	if ( bigInt.sign == -1 )
+		return -(int)(bigInt.data.bits[0] - 1) - 1;
+
+	return (int)bigInt.data.bits[0];
+};
+
+long long big_integer_to_long_long( const BigInteger bigInt )
+{
+	if ( bigInt.sign == 0 )
+		return 0;
+
+	int uIntNumBits = UINT_NUM_BITS;
+	int maxLength = sizeof(long long) / sizeof(unsigned int);
+
+	if ( BIG_INTEGER_CHECK( bigInt.data.length > maxLength, BIG_INTEGER_OVERFLOW ) )
+		return 0;
+
+	unsigned long long result = 0;
+	int i = 0;
+	for ( i = 0; i < bigInt.data.length; ++i )
+	{
+		result |= ((unsigned long long)bigInt.data.bits[i]) << (uIntNumBits * i);
+	}
+
+	/* the magnitude fits in 64 bits, but maybe not in a long long */
+	if ( BIG_INTEGER_CHECK( result > (unsigned long long) LLONG_MAX + (bigInt.sign == -1), BIG_INTEGER_OVERFLOW ) )
+		return 0;
+
+	/* written so that LLONG_MIN doesn't overflow */
+	if ( bigInt.sign == -1 )
+		return -(long long)(result - 1) - 1;
+
+	return result;
+};
+
+BigInteger big_integer_from_double( const double value )
+{
+	return big_integer_from_long_double( value );
+};
+
+BigInteger big_integer_from_long_double( const long double value )
+{
+	/* NaN and infinity */
+	if ( BIG_INTEGER_CHECK( value != value || value - value != 0, BIG_INTEGER_INVALID_ARGUMENT ) )
+		return big_integer_create( 0 );
+
+	BigInteger bigInt = big_integer_create( 0 );
+	long double remaining = value < 0 ? -value : value;
+	long double powers[BIG_INTEGER_DATA_MAX_SIZE];
+	int length = 0;
+	int i;
+
+	powers[0] = 1;
+	while ( length < BIG_INTEGER_DATA_MAX_SIZE - 1 && remaining >= powers[length] * 4294967296.0L )
+	{
+		powers[length + 1] = powers[length] * 4294967296.0L;
+		++length;
+	}
+	if ( BIG_INTEGER_CHECK( remaining >= powers[length] * 4294967296.0L, BIG_INTEGER_OVERFLOW ) )
+		return bigInt;
+	if ( remaining < 1 )
+		return bigInt;
+
+	/* dividing by powers of two and taking away the integer part are both exact */
+	for ( i = length; i >= 0; --i )
+	{
+		unsigned int limb = (unsigned int) (remaining / powers[i]);
+		remaining -= limb * powers[i];
+		bigInt.data.bits[i] = limb;
+	}
+
+	bigInt.data.length = length + 1;
+	bigInt.sign = value < 0 ? -1 : 1;
+
+	return bigInt;
+};
+
+double big_integer_to_double( const BigInteger bigInt )
+{
+	int exponent, numBits;
+	long double mantissa = big_integer_round_to_floating( bigInt, DBL_MANT_DIG, &exponent, &numBits );
+	return (double) big_integer_scale_long_double( mantissa, exponent );
+};
+
+long double big_integer_to_long_double( const BigInteger bigInt )
+{
+	int exponent, numBits;
+	long double mantissa = big_integer_round_to_floating( bigInt, LDBL_MANT_DIG, &exponent, &numBits );
+	return big_integer_scale_long_double( mantissa, exponent );
+};
+
+double big_integer_frexp( const BigInteger bigInt, int *exponent )
+{
+	int shift, numBits;
+	long double mantissa = big_integer_round_to_floating( bigInt, DBL_MANT_DIG, &shift, &numBits );
+	*exponent = shift + numBits;
+	return (double) big_integer_scale_long_double( mantissa, -numBits );
+};
+
+long double big_integer_frexp_long_double( const BigInteger bigInt, int *exponent )
+{
+	int shift, numBits;
+	long double mantissa = big_integer_round_to_floating( bigInt, LDBL_MANT_DIG, &shift, &numBits );
+	*exponent = shift + numBits;
+	return big_integer_scale_long_double( mantissa, -numBits );
+};
+
+int big_integer_compare( const BigInteger left, const BigInteger right )
+{
+	/* if one is positive and the other negative */
+	if ( left.sign > right.sign )
+		return 1;
+	if ( left.sign < right.sign )
+		return -1;
+	
+	/* if they have the same sign */
+	char sign = left.sign;
+	return sign * big_integer_compare_data( &left.data, &right.data );
+};
+
+BigInteger big_integer_add( const BigInteger left, const BigInteger right )
+{
+	if ( left.sign == 0 )
+		return right;
+	if ( right.sign == 0 )
+		return left;
+
+	if ( left.sign == right.sign )
+		return big_integer_create_internal( left.sign, big_integer_add_data( left.data, right.data ));
+
+	/* compare the MOD of the numbers */
+	int compRes = big_integer_compare_data( &left.data, &right.data );
+
+	if ( compRes == 0 )
+		return big_integer_create( 0 );
+
+	if ( compRes > 0 ) /* left > right */
+		return big_integer_create_internal( left.sign, big_integer_subtract_data( left.data, right.data ));
+
+	return big_integer_create_internal( right.sign, big_integer_subtract_data( right.data, left.data ));
+};
+
+BigInteger big_integer_subtract( const BigInteger left, const BigInteger right )
+{
+	if ( left.sign == 0 )
+		return big_integer_create_internal( -right.sign, right.data );
+	if ( right.sign == 0 )
+		return left;
+
+	if ( left.sign != right.sign )
+		return big_integer_create_internal( left.sign, big_integer_add_data(left.data, right.data) );
+
+	/* compare the MOD of the numbers */
+	int compRes = big_integer_compare_data( &left.data, &right.data );
+
+	if ( compRes == 0 )
+		return big_integer_create( 0 );
+
+	if ( compRes > 0 ) /* left > right */
+		return big_integer_create_internal( left.sign, big_integer_subtract_data(left.data, right.data) );
+
+	return big_integer_create_internal( -right.sign, big_integer_subtract_data(right.data, left.data) );
+};
+
+void big_integer_increment( BigInteger *bigInt, const unsigned int value )
+{
+	if ( bigInt->sign >= 0 ) /* bigInt >= 0 */
+	{
+		if ( bigInt->sign == 0 && value > 0 )
+			bigInt->sign = 1;
+		big_integer_increment_data( &bigInt->data, value );
+		if ( bigInt->data.length == 0 )
+			bigInt->sign = 0;
+	}
+	else /* bigInt < 0 */
+	{
+		int compRes = big_integer_compare_data_uint( &bigInt->data, value );
+
+		if ( compRes == 0 ) /* |bigInt| == |value| */
+		{
+			bigInt->sign = 0;
+			bigInt->data.length = 0;
+			big_integer_clear_trash_data( &bigInt->data );
+		}
+		else if ( compRes > 0 ) /* |bigInt| > |value| */
+		{
+			big_integer_decrement_data( &bigInt->data, value );
+		}
+		else /* |bigInt| < |value| */
+		{
+#ifdef DEBUG
+			/* |bigInt| < |value| implies that bigInt has length 1
+			   because value, if expressed as a BigInteger, would have length 1. */
+			assert( bigInt->data.length == 1 );
+#endif
+			bigInt->sign = 1;
+			bigInt->data.bits[0] = value - bigInt->data.bits[0];
+		}
+	}
+};
+
+void big_integer_decrement( BigInteger *bigInt, const unsigned int value )
+{
+	if ( bigInt->sign <= 0 )/* bigInt <= 0 */
+	{
+		if ( bigInt->sign == 0 && value > 0 )
+			bigInt->sign = -1;
+		big_integer_increment_data( &bigInt->data, value );
+		if ( bigInt->data.length == 0 )
+			bigInt->sign = 0;
+	}
+	else /* bigInt > 0 */
+	{
+		int compRes = big_integer_compare_data_uint( &bigInt->data, value );
+
+		if ( compRes == 0 ) /* |bigInt| == |value| */
+		{
+			bigInt->sign = 0;
+			bigInt->data.length = 0;
+			big_integer_clear_trash_data( &bigInt->data );
+		}
+		else if ( compRes > 0 ) /* |bigInt| > |value| */
+		{
+			big_integer_decrement_data( &bigInt->data, value );
+		}
+		else /* |bigInt| < |value| */
+		{
+#ifdef DEBUG
+			/* |bigInt| < |value| implies that bigInt has length 1 or less 
+			   because value, if expressed as a BigInteger, would have length 1. */
+			assert( bigInt->data.length == 1 );
+#endif
+			bigInt->sign = -1;
+			bigInt->data.bits[0] = value - bigInt->data.bits[0];
+		}
+	}
+};
+
+BigInteger big_integer_multiply( const BigInteger left, const BigInteger right )
+{
+	if ( left.sign == 0 || right.sign == 0 )
+		return big_integer_create( 0 );
+
+	return big_integer_create_internal( left.sign * right.sign, big_integer_multiply_data( left.data, right.data ) );
+};
+
+BigInteger big_integer_square( const BigInteger bigInt )
+{
+	if ( bigInt.sign == 0 )
+		return big_integer_create( 0 );
+
+	return big_integer_create_internal( 1, big_integer_square_data( bigInt.data ) );
+};
+
+BigInteger big_integer_pow_ui( const BigInteger base, const unsigned int exponent )
+{
+	if ( exponent == 0 )
+		return big_integer_create( 1 );
+	if ( base.sign == 0 )
+		return big_integer_create( 0 );
+
+	char sign = ( base.sign < 0 && (exponent & 1) ) ? -1 : 1;
+
+	/* powers of two are a single bit */
+	int k = big_integer_power_of_two_data( &base.data );
+	if ( k >= 0 )
+	{
+		unsigned long long bit = (unsigned long long) k * exponent;
+		if ( BIG_INTEGER_CHECK( bit >= (unsigned long long) UINT_NUM_BITS * BIG_INTEGER_DATA_MAX_SIZE, BIG_INTEGER_OVERFLOW ) )
+			return big_integer_create( 0 );
+
+		BigIntegerData data = big_integer_empty_data( );
+		data.length = (int) (bit / UINT_NUM_BITS) + 1;
+		data.bits[data.length-1] = 1u << (bit % UINT_NUM_BITS);
+
+		return big_integer_create_internal( sign, data );
+	}
+
+	/* left-to-right binary exponentiation. the result must fit in the capacity,
+	   so the exponent of any other base fits in 8 bits, too few for a sliding
+	   window to save any multiplication. */
+	unsigned int mask = 1u << (UINT_NUM_BITS - 1);
+	while ( (exponent & mask) == 0 )
+		mask >>= 1;
+
+	BigIntegerData result = base.data;
+	for ( mask >>= 1; mask > 0; mask >>= 1 )
+	{
+		result = big_integer_square_data( result );
+
+		if ( exponent & mask )
+		{
+			/* small bases only need a single word multiplication */
+			if ( base.data.length == 1 )
+				result = big_integer_mul_data_uint( result, base.data.bits[0] );
+			else
+				result = big_integer_multiply_data( result, base.data );
+		}
+	}
+
+	return big_integer_create_internal( sign, result );
+};
+
+BigInteger big_integer_mul_ui( const BigInteger bigInt, const unsigned int value )
+{
+	if ( bigInt.sign == 0 || value == 0 )
+		return big_integer_create( 0 );
+
+	return big_integer_create_internal( bigInt.sign, big_integer_mul_data_uint( bigInt.data, value ) );
+};
+
+BigInteger big_integer_divmod_ui( const BigInteger bigInt, const unsigned int divisor, unsigned int *remainder )
+{
+	if ( BIG_INTEGER_CHECK( divisor == 0, BIG_INTEGER_DIVISION_BY_ZERO ) )
+	{
+		if ( remainder )
+			*remainder = 0;
+		return big_integer_create( 0 );
+	}
+
+	BigIntegerData quotient = bigInt.data;
+	unsigned int rem = big_integer_divmod_data_uint( &quotient, divisor );
+
+	if ( remainder )
+		*remainder = rem;
+
+	return big_integer_create_quotient( bigInt.sign, quotient );
+};
+
+unsigned int big_integer_mod_ui( const BigInteger bigInt, const unsigned int divisor )
+{
+	unsigned int remainder;
+	big_integer_divmod_ui( bigInt, divisor, &remainder );
+
+	if ( bigInt.sign < 0 && remainder > 0 )
+		return divisor - remainder;
+
+	return remainder;
+};
+
+BigIntegerDivisor big_integer_create_divisor( const unsigned int divisor )
+{
+	if ( BIG_INTEGER_CHECK( divisor == 0, BIG_INTEGER_DIVISION_BY_ZERO ) )
+		return big_integer_create_divisor_internal( 1 );
+
+	return big_integer_create_divisor_internal( divisor );
+};
+
+BigInteger big_integer_divmod_divisor( const BigInteger bigInt, const BigIntegerDivisor *divisor, unsigned int *remainder )
+{
+	BigIntegerData quotient = bigInt.data;
+	unsigned int rem = big_integer_divmod_data_preinv( &quotient, divisor );
+
+	if ( remainder )
+		*remainder = rem;
+
+	return big_integer_create_quotient( bigInt.sign, quotient );
+};
+
+unsigned int big_integer_mod_divisor( const BigInteger bigInt, const BigIntegerDivisor *divisor )
+{
+	BigIntegerData quotient = bigInt.data;
+	unsigned int remainder = big_integer_divmod_data_preinv( &quotient, divisor );
+
+	if ( bigInt.sign < 0 && remainder > 0 )
+		return divisor->value - remainder;
+
+	return remainder;
+};
+
+BigIntegerModContext big_integer_create_mod_context( const BigInteger modulus )
+{
+	BigIntegerModContext context;
+
+	/* every operation on the empty context of an invalid modulus reports it and returns zero */
+	if ( BIG_INTEGER_CHECK( modulus.sign <= 0 || (modulus.data.bits[0] & 1) == 0 ||
+		big_integer_compare_data_uint( &modulus.data, 1 ) == 0, BIG_INTEGER_INVALID_ARGUMENT ) )
+	{
+		memset( &context, 0, sizeof(context) );
+		return context;
+	}
+
+	big_integer_montgomery_init( &context, &modulus.data );
+	return context;
+};
+
+BigInteger big_integer_mod_reduce( const BigIntegerModContext *context, const BigInteger bigInt )
+{
+	int length = context->modulus.length;
+	if ( BIG_INTEGER_CHECK( length == 0, BIG_INTEGER_INVALID_ARGUMENT ) || bigInt.sign == 0 )
+		return big_integer_create( 0 );
+
+	unsigned int plainOne[BIG_INTEGER_DATA_MAX_SIZE];
+	unsigned int chunk[BIG_INTEGER_DATA_MAX_SIZE];
+	unsigned int result[BIG_INTEGER_DATA_MAX_SIZE];
+	memset( plainOne, 0, sizeof(plainOne) );
+	memset( result, 0, sizeof(result) );
+	plainOne[0] = 1;
+
+	/* Horner's rule on chunks of length limbs, the digits base R, in Montgomery representation.
+	   multiplying a chunk (< R) by R^2 gives chunk * R, already reduced */
+	int i;
+	for ( i = (bigInt.data.length - 1) / length * length; i >= 0; i -= length )
+	{
+		memset( chunk, 0, sizeof(chunk) );
+		memcpy( chunk, bigInt.data.bits + i, sizeof(unsigned int) * MIN( length, bigInt.data.length - i ) );
+
+		big_integer_montgomery_multiply( context, result, result, context->rSquared );
+		big_integer_montgomery_multiply( context, chunk, chunk, context->rSquared );
+		big_integer_montgomery_add( context, result, result, chunk );
+	}
+	big_integer_montgomery_multiply( context, result, result, plainOne );
+
+	if ( bigInt.sign < 0 && !big_integer_is_zero_limbs( result, length ) )
+		big_integer_subtract_limbs( result, context->modulus.bits, result, length );
+
+	return big_integer_mod_store( context, result );
+};
+
+BigInteger big_integer_mod_add( const BigIntegerModContext *context, const BigInteger left, const BigInteger right )
+{
+	unsigned int a[BIG_INTEGER_DATA_MAX_SIZE], b[BIG_INTEGER_DATA_MAX_SIZE];
+	if ( !big_integer_mod_load( context, a, left ) || !big_integer_mod_load( context, b, right ) )
+		return big_integer_create( 0 );
+
+	big_integer_montgomery_add( context, a, a, b );
+	return big_integer_mod_store( context, a );
+};
+
+BigInteger big_integer_mod_subtract( const BigIntegerModContext *context, const BigInteger left, const BigInteger right )
+{
+	unsigned int a[BIG_INTEGER_DATA_MAX_SIZE], b[BIG_INTEGER_DATA_MAX_SIZE];
+	if ( !big_integer_mod_load( context, a, left ) || !big_integer_mod_load( context, b, right ) )
+		return big_integer_create( 0 );
+
+	big_integer_montgomery_subtract( context, a, a, b );
+	return big_integer_mod_store( context, a );
+};
+
+BigInteger big_integer_mod_multiply( const BigIntegerModContext *context, const BigInteger left, const BigInteger right )
+{
+	unsigned int a[BIG_INTEGER_DATA_MAX_SIZE], b[BIG_INTEGER_DATA_MAX_SIZE];
+	if ( !big_integer_mod_load( context, a, left ) || !big_integer_mod_load( context, b, right ) )
+		return big_integer_create( 0 );
+
+	/* left * right / R, then times R^2 / R */
+	big_integer_montgomery_multiply( context, a, a, b );
+	big_integer_montgomery_multiply( context, a, a, context->rSquared );
+	return big_integer_mod_store( context, a );
+};
+
+BigInteger big_integer_mod_square( const BigIntegerModContext *context, const BigInteger value )
+{
+	unsigned int a[BIG_INTEGER_DATA_MAX_SIZE];
+	if ( !big_integer_mod_load( context, a, value ) )
+		return big_integer_create( 0 );
+
+	big_integer_montgomery_multiply( context, a, a, a );
+	big_integer_montgomery_multiply( context, a, a, context->rSquared );
+	return big_integer_mod_store( context, a );
+};
+
+BigInteger big_integer_mod_inverse( const BigIntegerModContext *context, const BigInteger value )
+{
+	unsigned int a[BIG_INTEGER_DATA_MAX_SIZE];
+	if ( !big_integer_mod_load( context, a, value ) ||
+		BIG_INTEGER_CHECK( !big_integer_montgomery_inverse( context, a, a ), BIG_INTEGER_NOT_INVERTIBLE ) )
+		return big_integer_create( 0 );
+
+	return big_integer_mod_store( context, a );
+};
+
+void big_integer_batch_invert( const BigIntegerModContext *context, const BigInteger values[], BigInteger results[], const int count )
+{
+	unsigned int value[BIG_INTEGER_DATA_MAX_SIZE];
+	unsigned int inverse[BIG_INTEGER_DATA_MAX_SIZE];
+	unsigned int product[BIG_INTEGER_DATA_MAX_SIZE];
+	int i;
+
+	if ( count <= 0 )
+		return;
+
+	/* the limbs of results[i] first hold the prefix product values[0] * ... * values[i] / R^i.
+	   the Montgomery multiplications never leave the plain representation: the inverse of the
+	   last prefix carries exactly the R^(count - 1) that the way back divides out */
+	int loaded = big_integer_mod_load( context, results[0].data.bits, values[0] );
+	for ( i = 1; loaded && i < count; ++i )
+	{
+		loaded = big_integer_mod_load( context, value, values[i] );
+		big_integer_montgomery_multiply( context, results[i].data.bits, results[i-1].data.bits, value );
+	}
+
+	if ( !loaded || BIG_INTEGER_CHECK( !big_integer_montgomery_inverse( context, inverse, results[count-1].data.bits ), BIG_INTEGER_NOT_INVERTIBLE ) )
+	{
+		for ( i = 0; i < count; ++i )
+			results[i] = big_integer_create( 0 );
+		return;
+	}
+
+	/* inverse = (values[0] * ... * values[i])^-1 * R^i at step i */
+	for ( i = count - 1; i > 0; --i )
+	{
+		big_integer_montgomery_multiply( context, product, inverse, results[i-1].data.bits );
+		big_integer_mod_load( context, value, values[i] );
+		big_integer_montgomery_multiply( context, inverse, inverse, value );
+		results[i] = big_integer_mod_store( context, product );
+	}
+	results[0] = big_integer_mod_store( context, inverse );
+};
+
+int big_integer_is_probable_prime( const BigInteger bigInt, const int rounds )
+{
+	if ( bigInt.sign <= 0 )
+		return 0;
+
+	int result = big_integer_trial_division_data( &bigInt.data );
+	if ( result >= 0 )
+		return result;
+
+	return big_integer_probable_prime_data( &bigInt.data, rounds );
+};
+
+BigInteger big_integer_next_prime( const BigInteger bigInt )
+{
+	if ( big_integer_compare( bigInt, big_integer_create( 2 ) ) < 0 )
+		return big_integer_create( 2 );
+
+	/* the first odd number after bigInt */
+	BigInteger candidate = bigInt;
+	big_integer_increment( &candidate, (candidate.data.bits[0] & 1) ? 2 : 1 );
+
+	while ( candidate.data.length == 1 && candidate.data.bits[0] < SMALL_PRIMES_LIMIT )
+	{
+		if ( big_integer_trial_division_data( &candidate.data ) == 1 )
+			return candidate;
+		big_integer_increment( &candidate, 2 );
+	}
+
+	/* sieves the window candidate + 2k, 0 <= k < PRIME_SIEVE_SIZE, with the small primes
+	   and only runs the full test on the survivors */
+	char composite[PRIME_SIEVE_SIZE];
+	for (;;)
+	{
+		/* the increment overflowed, in flag mode it returns zero */
+		if ( candidate.sign == 0 )
+			return candidate;
+		if ( big_integer_cancellation_point( -1 ) )
+			return big_integer_create( 0 );
+
+		memset( composite, 0, sizeof(composite) );
+
+		int group;
+		for ( group = 0; group < SMALL_PRIMES_GROUPS_COUNT; ++group )
+		{
+			BigIntegerDivisor divisor = big_integer_create_divisor_internal( SMALL_PRIMES_PRODUCTS[group] );
+			BigIntegerData quotient = candidate.data;
+			unsigned int remainder = big_integer_divmod_data_preinv( &quotient, &divisor );
+
+			int i;
+			for ( i = SMALL_PRIMES_GROUPS[group]; i < SMALL_PRIMES_GROUPS[group+1]; ++i )
+			{
+				/* candidate + 2k = 0 mod p  <=>  k = -remainder / 2 mod p */
+				unsigned int p = SMALL_PRIMES[i];
+				unsigned int r = remainder % p;
+				unsigned int k = ( r == 0 ) ? 0 : ((p - r) * ((p + 1) / 2)) % p;
+
+				for ( ; k < PRIME_SIEVE_SIZE; k += p )
+					composite[k] = 1;
+			}
+		}
+
+		int k;
+		for ( k = 0; k < PRIME_SIEVE_SIZE; ++k )
+		{
+			if ( composite[k] )
+				continue;
+
+			BigInteger prime = candidate;
+			big_integer_increment( &prime, 2 * k );
+			if ( prime.sign == 0 || big_integer_probable_prime_data( &prime.data, 0 ) )
+				return prime;
+		}
+
+		big_integer_increment( &candidate, 2 * PRIME_SIEVE_SIZE );
+	}
+};
+
+void big_integer_is_probable_prime_batch( const BigInteger candidates[], int results[], const int count, const int rounds, const int numThreads )
+{
+	pthread_t threads[BIG_INTEGER_MAX_THREADS];
+	BigIntegerPrimeBatch batches[BIG_INTEGER_MAX_THREADS];
+	int started[BIG_INTEGER_MAX_THREADS];
+
+	int done = 0;
+	int cancelled = 0;
+
+	int num = MIN( MIN( numThreads, BIG_INTEGER_MAX_THREADS ), count );
+	if ( num < 1 )
+		num = 1;
+
+	int i;
+	for ( i = 0; i < num; ++i )
+	{
+		batches[i].candidates = candidates;
+		batches[i].results = results;
+		batches[i].count = count;
+		batches[i].rounds = rounds;
+		batches[i].first = i;
+		batches[i].step = num;
+		batches[i].done = &done;
+		batches[i].cancelled = &cancelled;
+		batches[i].reports = ( i == 0 );
+	}
+
+	/* the calling thread takes the first share, and any share whose thread can't be started */
+	for ( i = 1; i < num; ++i )
+		started[i] = pthread_create( &threads[i], NULL, big_integer_probable_prime_worker, &batches[i] ) == 0;
+
+	big_integer_probable_prime_worker( &batches[0] );
+
+	for ( i = 1; i < num; ++i )
+	{
+		if ( started[i] )
+			pthread_join( threads[i], NULL );
+		else
+		{
+			batches[i].reports = 1;
+			big_integer_probable_prime_worker( &batches[i] );
+		}
+	}
+};
+
+void big_integer_random_seed( BigIntegerRandomState *state, const unsigned long long seed )
+{
+	/* splitmix64 never produces the all zero xoshiro state */
+	unsigned long long splitmix = seed;
+	int i;
+	for ( i = 0; i < 4; ++i )
+		state->s[i] = big_integer_splitmix64( &splitmix );
+
+	state->source = NULL;
+	state->context = NULL;
+};
+
+void big_integer_random_set_source( BigIntegerRandomState *state, unsigned long long (*source)( void *context ), void *context )
+{
+	state->source = source;
+	state->context = context;
+};
+
+void big_integer_random_jump( BigIntegerRandomState *state )
+{
+	static const unsigned long long JUMP[] = {
+		0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+
+	unsigned long long s[4] = { 0, 0, 0, 0 };
+	int i, b, j;
+	for ( i = 0; i < 4; ++i )
+	{
+		for ( b = 0; b < 64; ++b )
+		{
+			if ( JUMP[i] & (1ULL << b) )
+				for ( j = 0; j < 4; ++j )
+					s[j] ^= state->s[j];
+
+			/* steps the xoshiro state, whatever the source is */
+			unsigned long long t = state->s[1] << 17;
+			state->s[2] ^= state->s[0];
+			state->s[3] ^= state->s[1];
+			state->s[1] ^= state->s[2];
+			state->s[0] ^= state->s[3];
+			state->s[2] ^= t;
+			state->s[3] = big_integer_rotl64( state->s[3], 45 );
+		}
+	}
+
+	memcpy( state->s, s, sizeof(s) );
+};
+
+unsigned long long big_integer_random_next( BigIntegerRandomState *state )
+{
+	if ( state->source )
+		return state->source( state->context );
+
+	/* xoshiro256** by Blackman & Vigna */
+	unsigned long long *s = state->s;
+	unsigned long long result = big_integer_rotl64( s[1] * 5, 7 ) * 9;
+	unsigned long long t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = big_integer_rotl64( s[3], 45 );
+
+	return result;
+};
+
+BigIntegerRandomState *big_integer_random_thread_state( )
+{
+	if ( !THREAD_RANDOM_SEEDED )
+	{
+		/* distinct for every thread, even when they start within the same second */
+		unsigned long long seed = (unsigned long long) time( NULL );
+		seed ^= __atomic_add_fetch( &THREAD_RANDOM_COUNTER, 1, __ATOMIC_RELAXED ) * 0x9E3779B97F4A7C15ULL;
+		seed ^= (unsigned long long) (size_t) &THREAD_RANDOM_STATE;
+
+		big_integer_random_seed( &THREAD_RANDOM_STATE, seed );
+		THREAD_RANDOM_SEEDED = 1;
+	}
+
+	return &THREAD_RANDOM_STATE;
+};
+
+BigInteger big_integer_random_bits( const int numBits )
+{
+	return big_integer_random_bits_r( big_integer_random_thread_state( ), numBits );
+};
+
+BigInteger big_integer_random_bits_r( BigIntegerRandomState *state, const int numBits )
+{
+	if ( BIG_INTEGER_CHECK( numBits > UINT_NUM_BITS * BIG_INTEGER_DATA_MAX_SIZE, BIG_INTEGER_OVERFLOW ) ||
+		BIG_INTEGER_CHECK( numBits < 0, BIG_INTEGER_INVALID_ARGUMENT ) || numBits == 0 )
+		return big_integer_create( 0 );
+
+	BigIntegerData data = big_integer_random_data( state, numBits );
+	if ( data.length == 0 )
+		return big_integer_create( 0 );
+
+	return big_integer_create_internal( 1, data );
+};
+
+BigInteger big_integer_random_below( const BigInteger limit )
+{
+	return big_integer_random_below_r( big_integer_random_thread_state( ), limit );
+};
+
+BigInteger big_integer_random_below_r( BigIntegerRandomState *state, const BigInteger limit )
+{
+	if ( BIG_INTEGER_CHECK( limit.sign <= 0, BIG_INTEGER_INVALID_ARGUMENT ) )
+		return big_integer_create( 0 );
+
+	/* rejection sampling with as many bits as the limit, more than half of the draws are accepted */
+	int numBits = big_integer_bit_length_limbs( limit.data.bits, limit.data.length );
+	BigIntegerData data;
+	do
+	{
+		data = big_integer_random_data( state, numBits );
+	} while ( big_integer_compare_limbs( data.bits, limit.data.bits, limit.data.length ) >= 0 );
+
+	if ( data.length == 0 )
+		return big_integer_create( 0 );
+
+	return big_integer_create_internal( 1, data );
+};
+
+int big_integer_write_decimal( FILE *file, const BigInteger bigInt )
+{
+	return big_integer_write_decimal_callback( bigInt, big_integer_write_file_func, file );
+};
+
+int big_integer_write_decimal_callback( const BigInteger bigInt, BigIntegerWriteFunc write, void *context )
+{
+	/* the chunks come out least significant first. with the capacity of a BigInteger
+	   they all fit on the stack, and only one chunk of digits is ever formatted */
+	unsigned int chunks[DECIMAL_MAX_CHUNKS];
+	char digits[DECIMAL_CHUNK_DIGITS];
+	int numChunks = 0;
+	int written = 0;
+
+	if ( bigInt.sign < 0 )
+	{
+		if ( write( "-", 1, context ) != 0 )
+			return -1;
+		written++;
+	}
+
+	BigIntegerDivisor divisor = big_integer_create_divisor_internal( DECIMAL_CHUNK );
+	BigIntegerData quotient = bigInt.data;
+	do
+	{
+		chunks[numChunks++] = big_integer_divmod_data_preinv( &quotient, &divisor );
+
+		int from = quotient.length - 1;
+		quotient.length = 0;
+		big_integer_normalize_from( &quotient, from );
+	} while ( quotient.length > 0 );
+
+	int i;
+	for ( i = numChunks - 1; i >= 0; --i )
+	{
+		/* every chunk but the most significant one keeps its leading zeros */
+		unsigned int chunk = chunks[i];
+		int length = 0;
+		int j;
+		for ( j = DECIMAL_CHUNK_DIGITS - 1; j >= 0; --j )
+		{
+			digits[j] = (char) ('0' + chunk % 10);
+			chunk /= 10;
+		}
+		if ( i == numChunks - 1 )
+			while ( length < DECIMAL_CHUNK_DIGITS - 1 && digits[length] == '0' )
+				length++;
+
+		if ( write( digits + length, DECIMAL_CHUNK_DIGITS - length, context ) != 0 )
+			return -1;
+		written += DECIMAL_CHUNK_DIGITS - length;
+	}
+
+	return written;
+};
+
+const char *big_integer_status_string( const BigIntegerStatus status )
+{
+	switch ( status )
+	{
+		case BIG_INTEGER_OK:				return "no error";
+		case BIG_INTEGER_OVERFLOW:			return "overflow";
+		case BIG_INTEGER_DIVISION_BY_ZERO:	return "division by zero";
+		case BIG_INTEGER_INVALID_ARGUMENT:	return "invalid argument";
+		case BIG_INTEGER_CANCELLED:			return "cancelled";
+		case BIG_INTEGER_NOT_INVERTIBLE:	return "not invertible";
+		case BIG_INTEGER_OUT_OF_MEMORY:		return "out of memory";
+	}
+
+	return "unknown error";
+};
+
+void big_integer_set_error_mode( const BigIntegerErrorMode mode )
+{
+	THREAD_ERROR_MODE = mode;
+};
+
+BigIntegerErrorMode big_integer_get_error_mode( )
+{
+	return THREAD_ERROR_MODE;
+};
+
+BigIntegerStatus big_integer_last_error( )
+{
+	return THREAD_LAST_ERROR;
+};
+
+void big_integer_clear_error( )
+{
+	THREAD_LAST_ERROR = BIG_INTEGER_OK;
+};
+
+void big_integer_set_progress( BigIntegerProgressFunc progress, void *context )
+{
+	THREAD_PROGRESS = progress;
+	THREAD_PROGRESS_CONTEXT = context;
+};
+
+void big_integer_get_progress( BigIntegerProgressFunc *progress, void **context )
+{
+	*progress = THREAD_PROGRESS;
+	*context = THREAD_PROGRESS_CONTEXT;
+};
+
+void big_integer_set_memory_functions( void *(*allocate)( size_t size ), void (*release)( void *pointer ) )
+{
+	MEMORY_ALLOCATE = allocate ? allocate : malloc;
+	MEMORY_FREE = release ? release : free;
+};
+
+BigIntegerStatus big_integer_to_int_checked( const BigInteger bigInt, int *result )
+{
+	BigIntegerErrorState saved = big_integer_begin_checked( );
+	int value = big_integer_to_int( bigInt );
+	BigIntegerStatus status = big_integer_end_checked( saved );
+
+	if ( status == BIG_INTEGER_OK )
+		*result = value;
+	return status;
+};
+
+BigIntegerStatus big_integer_to_long_long_checked( const BigInteger bigInt, long long *result )
+{
+	BigIntegerErrorState saved = big_integer_begin_checked( );
+	long long value = big_integer_to_long_long( bigInt );
+	BigIntegerStatus status = big_integer_end_checked( saved );
+
+	if ( status == BIG_INTEGER_OK )
+		*result = value;
+	return status;
+};
+
+BigIntegerStatus big_integer_from_double_checked( const double value, BigInteger *result )
+{
+	BigIntegerErrorState saved = big_integer_begin_checked( );
+	BigInteger bigInt = big_integer_from_double( value );
+	BigIntegerStatus status = big_integer_end_checked( saved );
+
+	if ( status == BIG_INTEGER_OK )
+		*result = bigInt;
+	return status;
+};
+
+BigIntegerStatus big_integer_add_checked( const BigInteger left, const BigInteger right, BigInteger *result )
+{
+	BigIntegerErrorState saved = big_integer_begin_checked( );
+	BigInteger bigInt = big_integer_add( left, right );
+	BigIntegerStatus status = big_integer_end_checked( saved );
+
+	if ( status == BIG_INTEGER_OK )
+		*result = bigInt;
+	return status;
+};
+
+BigIntegerStatus big_integer_subtract_checked( const BigInteger left, const BigInteger right, BigInteger *result )
+{
+	BigIntegerErrorState saved = big_integer_begin_checked( );
+	BigInteger bigInt = big_integer_subtract( left, right );
+	BigIntegerStatus status = big_integer_end_checked( saved );
+
+	if ( status == BIG_INTEGER_OK )
+		*result = bigInt;
+	return status;
+};
+
+BigIntegerStatus big_integer_increment_checked( BigInteger *bigInt, const unsigned int value )
+{
+	BigIntegerErrorState saved = big_integer_begin_checked( );
+	BigInteger result = *bigInt;
+	big_integer_increment( &result, value );
+	BigIntegerStatus status = big_integer_end_checked( saved );
+
+	if ( status == BIG_INTEGER_OK )
+		*bigInt = result;
+	return status;
+};
+
+BigIntegerStatus big_integer_decrement_checked( BigInteger *bigInt, const unsigned int value )
+{
+	BigIntegerErrorState saved = big_integer_begin_checked( );
+	BigInteger result = *bigInt;
+	big_integer_decrement( &result, value );
+	BigIntegerStatus status = big_integer_end_checked( saved );
+
+	if ( status == BIG_INTEGER_OK )
+		*bigInt = result;
+	return status;
+};
+
+BigIntegerStatus big_integer_multiply_checked( const BigInteger left, const BigInteger right, BigInteger *result )
+{
+	BigIntegerErrorState saved = big_integer_begin_checked( );
+	BigInteger bigInt = big_integer_multiply( left, right );
+	BigIntegerStatus status = big_integer_end_checked( saved );
+
+	if ( status == BIG_INTEGER_OK )
+		*result = bigInt;
+	return status;
+};
+
+BigIntegerStatus big_integer_mul_ui_checked( const BigInteger bigInt, const unsigned int value, BigInteger *result )
+{
+	BigIntegerErrorState saved = big_integer_begin_checked( );
+	BigInteger product = big_integer_mul_ui( bigInt, value );
+	BigIntegerStatus status = big_integer_end_checked( saved );
+
+	if ( status == BIG_INTEGER_OK )
+		*result = product;
+	return status;
+};
+
+BigIntegerStatus big_integer_pow_ui_checked( const BigInteger base, const unsigned int exponent, BigInteger *result )
+{
+	BigIntegerErrorState saved = big_integer_begin_checked( );
+	BigInteger power = big_integer_pow_ui( base, exponent );
+	BigIntegerStatus status = big_integer_end_checked( saved );
+
+	if ( status == BIG_INTEGER_OK )
+		*result = power;
+	return status;
+};
+
+BigIntegerStatus big_integer_divmod_ui_checked( const BigInteger bigInt, const unsigned int divisor, BigInteger *quotient, unsigned int *remainder )
+{
+	BigIntegerErrorState saved = big_integer_begin_checked( );
+	unsigned int rem;
+	BigInteger quot = big_integer_divmod_ui( bigInt, divisor, &rem );
+	BigIntegerStatus status = big_integer_end_checked( saved );
+
+	if ( status == BIG_INTEGER_OK )
+	{
+		if ( quotient )
+			*quotient = quot;
+		if ( remainder )
+			*remainder = rem;
+	}
+	return status;
+};
+
+BigIntegerStatus big_integer_mod_inverse_checked( const BigIntegerModContext *context, const BigInteger value, BigInteger *result )
+{
+	BigIntegerErrorState saved = big_integer_begin_checked( );
+	BigInteger inverse = big_integer_mod_inverse( context, value );
+	BigIntegerStatus status = big_integer_end_checked( saved );
+
+	if ( status == BIG_INTEGER_OK )
+		*result = inverse;
+	return status;
 };
 
 #ifdef DEBUG
@@ -456,5 +2486,8 @@ void big_integer_dump( const BigInteger bigInt )
 	}
 	printf("}\n");
 	printf("Length: %d\n", bigInt.data.length);
+	printf("Value: ");
+	big_integer_write_decimal( stdout, bigInt );
+	printf("\n");
 }
 #endif
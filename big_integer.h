@@ -7,7 +7,10 @@
 **     Author: Andre Azevedo <http://github.com/andreazevedo>
 **/
 
+#include <stdio.h>
+
 #define BIG_INTEGER_DATA_MAX_SIZE	8
+#define BIG_INTEGER_MAX_THREADS		64
 
 typedef struct BigIntegerData
 {
@@ -21,6 +24,60 @@ typedef struct BigInteger
 	BigIntegerData data;
 } BigInteger;
 
+/* precomputed single word divisor (Moller-Granlund 2/1 division by invariant integer) */
+typedef struct BigIntegerDivisor
+{
+	unsigned int value;			/* the divisor itself */
+	unsigned int normalized;	/* value << shift, so its most significant bit is set */
+	unsigned int inverse;		/* floor( (2^64 - 1) / normalized ) - 2^32 */
+	int shift;
+} BigIntegerDivisor;
+
+/* precomputed odd modulus for modular arithmetic. internally x is stored in Montgomery
+   representation, as x * R mod modulus where R = 2^(32 * modulus.length), with modulus.length limbs */
+typedef struct BigIntegerModContext
+{
+	BigIntegerData modulus;
+	unsigned int inverse;								/* -modulus^-1 mod 2^32 */
+	unsigned int one[BIG_INTEGER_DATA_MAX_SIZE];		/* R mod modulus */
+	unsigned int rSquared[BIG_INTEGER_DATA_MAX_SIZE];	/* R^2 mod modulus */
+} BigIntegerModContext;
+
+/* results of the checked functions and errors recorded for each thread */
+typedef enum BigIntegerStatus
+{
+	BIG_INTEGER_OK = 0,
+	BIG_INTEGER_OVERFLOW,
+	BIG_INTEGER_DIVISION_BY_ZERO,
+	BIG_INTEGER_INVALID_ARGUMENT,
+	BIG_INTEGER_CANCELLED,				/* stopped by the progress function */
+	BIG_INTEGER_NOT_INVERTIBLE,			/* the value shares a factor with the modulus */
+	BIG_INTEGER_OUT_OF_MEMORY
+} BigIntegerStatus;
+
+/* what a function without a status does when it fails, set for each thread */
+typedef enum BigIntegerErrorMode
+{
+	BIG_INTEGER_ERROR_ABORT = 0,	/* reports the error on stderr and aborts (the default) */
+	BIG_INTEGER_ERROR_FLAG			/* records the error for big_integer_last_error and returns zero */
+} BigIntegerErrorMode;
+
+/* receives the progress of a long operation, from 0 to 1, or -1 when it isn't known.
+   returning nonzero cancels it: it returns zero and records BIG_INTEGER_CANCELLED */
+typedef int (*BigIntegerProgressFunc)( const double progress, void *context );
+
+/* random number generator state. xoshiro256** unless another 64 bit source is set */
+typedef struct BigIntegerRandomState
+{
+	unsigned long long s[4];
+	unsigned long long (*source)( void *context );
+	void *context;
+} BigIntegerRandomState;
+
+/* receives the digits written by big_integer_write_decimal_callback, in order.
+   returns 0 to continue, anything else to stop the writing */
+typedef int (*BigIntegerWriteFunc)( const char *digits, const int length, void *context );
+
 /* creates a big integer number */
 BigInteger big_integer_create( long long value );
 
@@ -30,6 +87,18 @@ int big_integer_to_int( const BigInteger bigInt );
 /* returns the big integer as long long */
 long long big_integer_to_long_long( const BigInteger bigInt );
 
+/* creates a big integer from the integer part of value. NaN and infinity are invalid */
+BigInteger big_integer_from_double( const double value );
+BigInteger big_integer_from_long_double( const long double value );
+
+/* returns the big integer rounded to the nearest double, ties to even */
+double big_integer_to_double( const BigInteger bigInt );
+long double big_integer_to_long_double( const BigInteger bigInt );
+
+/* returns the rounded big integer as mantissa * 2^exponent, with 0.5 <= |mantissa| < 1 (like frexp) */
+double big_integer_frexp( const BigInteger bigInt, int *exponent );
+long double big_integer_frexp_long_double( const BigInteger bigInt, int *exponent );
+
 /* compare big integers */
 int big_integer_compare( const BigInteger left, const BigInteger right );
 
@@ -45,6 +114,139 @@ void big_integer_increment( BigInteger *bigInt, const unsigned int value );
 /* decrements the bigInteger by the amount specified */
 void big_integer_decrement( BigInteger *bigInt, const unsigned int value );
 
+/* multiplies two big integers ( left * right ) */
+BigInteger big_integer_multiply( const BigInteger left, const BigInteger right );
+
+/* squares the big integer ( bigInt * bigInt ) */
+BigInteger big_integer_square( const BigInteger bigInt );
+
+/* raises the big integer to the power specified ( base ^ exponent ), with 0 ^ 0 = 1 */
+BigInteger big_integer_pow_ui( const BigInteger base, const unsigned int exponent );
+
+/* multiplies the big integer by an unsigned int ( bigInt * value ) */
+BigInteger big_integer_mul_ui( const BigInteger bigInt, const unsigned int value );
+
+/* divides the big integer by an unsigned int, truncating towards zero ( bigInt / divisor ).
+   if remainder is not NULL, it receives the absolute value of the remainder */
+BigInteger big_integer_divmod_ui( const BigInteger bigInt, const unsigned int divisor, unsigned int *remainder );
+
+/* returns bigInt modulo divisor, in the range [0, divisor) */
+unsigned int big_integer_mod_ui( const BigInteger bigInt, const unsigned int divisor );
+
+/* precomputes the inverse of divisor, so repeated divisions by it need no hardware division */
+BigIntegerDivisor big_integer_create_divisor( const unsigned int divisor );
+
+/* same as big_integer_divmod_ui, using a precomputed divisor */
+BigInteger big_integer_divmod_divisor( const BigInteger bigInt, const BigIntegerDivisor *divisor, unsigned int *remainder );
+
+/* same as big_integer_mod_ui, using a precomputed divisor */
+unsigned int big_integer_mod_divisor( const BigInteger bigInt, const BigIntegerDivisor *divisor );
+
+/* precomputes the modular arithmetic of modulus, which must be odd and greater than 1. the
+   functions below report BIG_INTEGER_INVALID_ARGUMENT and return zero for any other modulus */
+BigIntegerModContext big_integer_create_mod_context( const BigInteger modulus );
+
+/* returns bigInt modulo the context's modulus, in the range [0, modulus) */
+BigInteger big_integer_mod_reduce( const BigIntegerModContext *context, const BigInteger bigInt );
+
+/* modular operations on values already reduced to [0, modulus), with results in the same range.
+   a value out of that range reports BIG_INTEGER_INVALID_ARGUMENT and gives zero */
+BigInteger big_integer_mod_add( const BigIntegerModContext *context, const BigInteger left, const BigInteger right );
+BigInteger big_integer_mod_subtract( const BigIntegerModContext *context, const BigInteger left, const BigInteger right );
+BigInteger big_integer_mod_multiply( const BigIntegerModContext *context, const BigInteger left, const BigInteger right );
+BigInteger big_integer_mod_square( const BigIntegerModContext *context, const BigInteger value );
+
+/* returns the inverse of a reduced value, or reports BIG_INTEGER_NOT_INVERTIBLE when
+   the value and the modulus aren't coprime */
+BigInteger big_integer_mod_inverse( const BigIntegerModContext *context, const BigInteger value );
+
+/* results[i] = values[i]^-1 for count reduced values, with a single inversion and 3 (count - 1)
+   multiplications (Montgomery's trick). if any value isn't invertible, it reports
+   BIG_INTEGER_NOT_INVERTIBLE and every result is zero, the same as an unreduced value does with
+   BIG_INTEGER_INVALID_ARGUMENT. results must not overlap values */
+void big_integer_batch_invert( const BigIntegerModContext *context, const BigInteger values[], BigInteger results[], const int count );
+
+/* returns 1 if the big integer is a probable prime, 0 if it is composite (or < 2).
+   rounds <= 0 runs the Baillie-PSW test, rounds > 0 runs that many Miller-Rabin
+   rounds with the first prime bases ( 2, 3, 5, ..., 251 ). rounds beyond those 54 take
+   random bases from the calling thread's random state */
+int big_integer_is_probable_prime( const BigInteger bigInt, const int rounds );
+
+/* returns the smallest (Baillie-PSW) probable prime greater than bigInt */
+BigInteger big_integer_next_prime( const BigInteger bigInt );
+
+/* runs big_integer_is_probable_prime on every candidate, spread across numThreads threads.
+   when cancelled, the results of the candidates not yet tested are left as they were */
+void big_integer_is_probable_prime_batch( const BigInteger candidates[], int results[], const int count, const int rounds, const int numThreads );
+
+/* seeds the xoshiro256** generator of the state (and drops any custom source) */
+void big_integer_random_seed( BigIntegerRandomState *state, const unsigned long long seed );
+
+/* makes the state draw its 64 bit words from source( context ) */
+void big_integer_random_set_source( BigIntegerRandomState *state, unsigned long long (*source)( void *context ), void *context );
+
+/* advances the xoshiro256** generator by 2^128 words, so states seeded alike and
+   jumped 0, 1, 2, ... times produce non-overlapping streams for parallel use */
+void big_integer_random_jump( BigIntegerRandomState *state );
+
+/* returns the next 64 random bits of the state */
+unsigned long long big_integer_random_next( BigIntegerRandomState *state );
+
+/* returns the calling thread's own state, used by the functions without a state argument */
+BigIntegerRandomState *big_integer_random_thread_state( );
+
+/* returns a uniformly distributed random number in [0, 2^numBits). a negative numBits
+   reports BIG_INTEGER_INVALID_ARGUMENT, one too large for a BigInteger BIG_INTEGER_OVERFLOW */
+BigInteger big_integer_random_bits( const int numBits );
+BigInteger big_integer_random_bits_r( BigIntegerRandomState *state, const int numBits );
+
+/* returns a uniformly distributed random number in [0, limit), limit > 0 */
+BigInteger big_integer_random_below( const BigInteger limit );
+BigInteger big_integer_random_below_r( BigIntegerRandomState *state, const BigInteger limit );
+
+/* writes the big integer in decimal to file. returns the number of characters written, -1 on error */
+int big_integer_write_decimal( FILE *file, const BigInteger bigInt );
+
+/* passes the big integer in decimal to write, a few digits at a time. returns the number
+   of characters written, -1 if write stopped it */
+int big_integer_write_decimal_callback( const BigInteger bigInt, BigIntegerWriteFunc write, void *context );
+
+/* returns a description of the status */
+const char *big_integer_status_string( const BigIntegerStatus status );
+
+/* sets how the calling thread handles errors */
+void big_integer_set_error_mode( const BigIntegerErrorMode mode );
+BigIntegerErrorMode big_integer_get_error_mode( );
+
+/* returns the first error of the calling thread since it was last cleared */
+BigIntegerStatus big_integer_last_error( );
+void big_integer_clear_error( );
+
+/* sets the progress function for the long operations of the calling thread (next_prime and
+   is_probable_prime_batch), NULL for none */
+void big_integer_set_progress( BigIntegerProgressFunc progress, void *context );
+void big_integer_get_progress( BigIntegerProgressFunc *progress, void **context );
+
+/* sets the functions that allocate and free the memory of batches, shared values and futures,
+   NULL for malloc and free. set them before other threads use the library. a failed
+   allocation reports BIG_INTEGER_OUT_OF_MEMORY */
+void big_integer_set_memory_functions( void *(*allocate)( size_t size ), void (*release)( void *pointer ) );
+
+/* the checked functions never abort nor change the thread's error state. they return the
+   status and only write the result when it is BIG_INTEGER_OK */
+BigIntegerStatus big_integer_to_int_checked( const BigInteger bigInt, int *result );
+BigIntegerStatus big_integer_to_long_long_checked( const BigInteger bigInt, long long *result );
+BigIntegerStatus big_integer_from_double_checked( const double value, BigInteger *result );
+BigIntegerStatus big_integer_add_checked( const BigInteger left, const BigInteger right, BigInteger *result );
+BigIntegerStatus big_integer_subtract_checked( const BigInteger left, const BigInteger right, BigInteger *result );
+BigIntegerStatus big_integer_increment_checked( BigInteger *bigInt, const unsigned int value );
+BigIntegerStatus big_integer_decrement_checked( BigInteger *bigInt, const unsigned int value );
+BigIntegerStatus big_integer_multiply_checked( const BigInteger left, const BigInteger right, BigInteger *result );
+BigIntegerStatus big_integer_mul_ui_checked( const BigInteger bigInt, const unsigned int value, BigInteger *result );
+BigIntegerStatus big_integer_pow_ui_checked( const BigInteger base, const unsigned int exponent, BigInteger *result );
+BigIntegerStatus big_integer_divmod_ui_checked( const BigInteger bigInt, const unsigned int divisor, BigInteger *quotient, unsigned int *remainder );
+BigIntegerStatus big_integer_mod_inverse_checked( const BigIntegerModContext *context, const BigInteger value, BigInteger *result );
+
 
 #ifdef DEBUG
 void big_integer_dump( const BigInteger bigInt );
@@ -0,0 +1,431 @@
+/*
+** big_integer_async.c
+**     Description: Runs the long operations on a pool of worker threads and
+**                  returns futures to poll, wait for or cancel.
+**/
+
+#include <pthread.h>
+#include "macros.h"
+#include "big_integer_async.h"
+#include "big_integer_internal.h"
+
+typedef enum BigIntegerAsyncOperation
+{
+	BIG_INTEGER_ASYNC_MULTIPLY,
+	BIG_INTEGER_ASYNC_POW_UI,
+	BIG_INTEGER_ASYNC_NEXT_PRIME,
+	BIG_INTEGER_ASYNC_PRIME_BATCH
+} BigIntegerAsyncOperation;
+
+struct BigIntegerFuture
+{
+	BigIntegerAsyncOperation operation;
+	BigInteger left;
+	BigInteger right;
+	unsigned int exponent;
+	const BigInteger *candidates;
+	int *results;
+	int count;
+	int rounds;
+	BigIntegerProgressFunc progressFunc;	/* the submitting thread's, see big_integer_set_progress */
+	void *progressContext;
+
+	/* a batch is split in shares, each run by one worker of the pool */
+	int shares;
+	int claimed;					/* shares taken by the workers, under ASYNC_LOCK */
+	int running;					/* shares being run, under ASYNC_LOCK */
+	double shareProgress[BIG_INTEGER_MAX_THREADS];	/* atomic */
+
+	BigInteger result;
+	BigIntegerStatus status;		/* the first error of its shares, under ASYNC_LOCK */
+	BigIntegerAsyncState state;		/* written under ASYNC_LOCK, read atomically */
+	int cancelled;					/* atomic */
+	double progress;				/* atomic */
+	int references;					/* the caller's and the pool's, under ASYNC_LOCK */
+	BigIntegerFuture *next;
+};
+
+/* what a worker reports the progress of */
+typedef struct BigIntegerAsyncShare
+{
+	BigIntegerFuture *future;
+	int share;
+} BigIntegerAsyncShare;
+
+/* the queue and the workers, all under ASYNC_LOCK */
+pthread_mutex_t ASYNC_LOCK = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t ASYNC_QUEUED = PTHREAD_COND_INITIALIZER;
+pthread_cond_t ASYNC_FINISHED = PTHREAD_COND_INITIALIZER;
+BigIntegerFuture *ASYNC_HEAD = NULL;
+BigIntegerFuture *ASYNC_TAIL = NULL;
+pthread_t ASYNC_THREADS[BIG_INTEGER_MAX_THREADS];
+int ASYNC_THREADS_COUNT = 0;
+int ASYNC_STOPPING = 0;
+
+
+/* PRIVATE FUNCTIONS DECLARATIONS */
+int big_integer_async_start_locked( const int numThreads );
+void *big_integer_async_worker( void *unused );
+BigIntegerStatus big_integer_async_run( BigIntegerFuture *future, const int share );
+int big_integer_async_report( const double progress, void *context );
+void big_integer_async_unqueue_locked( BigIntegerFuture *future );
+void big_integer_async_cancel_locked( BigIntegerFuture *future );
+void big_integer_async_complete_locked( BigIntegerFuture *future );
+void big_integer_async_finish_locked( BigIntegerFuture *future );
+void big_integer_async_release_locked( BigIntegerFuture *future );
+BigIntegerFuture *big_integer_async_create( const BigIntegerAsyncOperation operation );
+BigIntegerFuture *big_integer_async_submit( BigIntegerFuture *future );
+
+
+/* PRIVATE FUNCTIONS IMPLEMENTATION */
+int big_integer_async_start_locked( const int numThreads )
+{
+	int num = MIN( numThreads, BIG_INTEGER_MAX_THREADS );
+	while ( ASYNC_THREADS_COUNT < num &&
+		pthread_create( &ASYNC_THREADS[ASYNC_THREADS_COUNT], NULL, big_integer_async_worker, NULL ) == 0 )
+		ASYNC_THREADS_COUNT++;
+
+	return ( ASYNC_THREADS_COUNT > 0 ) ? 0 : -1;
+};
+
+void *big_integer_async_worker( void *unused )
+{
+	/* errors become the status of the future instead of aborting */
+	big_integer_set_error_mode( BIG_INTEGER_ERROR_FLAG );
+
+	for (;;)
+	{
+		pthread_mutex_lock( &ASYNC_LOCK );
+		while ( !ASYNC_HEAD && !ASYNC_STOPPING )
+			pthread_cond_wait( &ASYNC_QUEUED, &ASYNC_LOCK );
+
+		BigIntegerFuture *future = ASYNC_HEAD;
+		if ( !future )
+		{
+			pthread_mutex_unlock( &ASYNC_LOCK );
+			return NULL;
+		}
+
+		/* the future leaves the queue once its last share is taken */
+		int share = future->claimed++;
+		if ( future->claimed == future->shares )
+			big_integer_async_unqueue_locked( future );
+		if ( ASYNC_HEAD )
+			pthread_cond_signal( &ASYNC_QUEUED );
+		future->running++;
+		__atomic_store_n( &future->state, BIG_INTEGER_ASYNC_RUNNING, __ATOMIC_RELEASE );
+		pthread_mutex_unlock( &ASYNC_LOCK );
+
+		BigIntegerStatus status = big_integer_async_run( future, share );
+
+		pthread_mutex_lock( &ASYNC_LOCK );
+		if ( future->status == BIG_INTEGER_OK )
+			future->status = status;
+		if ( --future->running == 0 && future->claimed == future->shares )
+			big_integer_async_complete_locked( future );
+		pthread_mutex_unlock( &ASYNC_LOCK );
+	}
+};
+
+/* runs one share of the future on the calling worker, never on threads of its own */
+BigIntegerStatus big_integer_async_run( BigIntegerFuture *future, const int share )
+{
+	BigIntegerAsyncShare context;
+	context.future = future;
+	context.share = share;
+
+	big_integer_clear_error( );
+	big_integer_set_progress( big_integer_async_report, &context );
+
+	switch ( future->operation )
+	{
+	case BIG_INTEGER_ASYNC_MULTIPLY:
+		future->result = big_integer_multiply( future->left, future->right );
+		break;
+
+	case BIG_INTEGER_ASYNC_POW_UI:
+		future->result = big_integer_pow_ui( future->left, future->exponent );
+		break;
+
+	case BIG_INTEGER_ASYNC_NEXT_PRIME:
+		future->result = big_integer_next_prime( future->left );
+		break;
+
+	case BIG_INTEGER_ASYNC_PRIME_BATCH:
+		{
+			int first = (int) ((long long) future->count * share / future->shares);
+			int end = (int) ((long long) future->count * (share + 1) / future->shares);
+			big_integer_is_probable_prime_batch( future->candidates + first, future->results + first, end - first, future->rounds, 1 );
+		}
+		break;
+	}
+
+	big_integer_set_progress( NULL, NULL );
+	return big_integer_last_error( );
+};
+
+int big_integer_async_report( const double progress, void *context )
+{
+	BigIntegerAsyncShare *share = (BigIntegerAsyncShare *) context;
+	BigIntegerFuture *future = share->future;
+
+	if ( future->operation == BIG_INTEGER_ASYNC_PRIME_BATCH )
+		__atomic_store( &future->shareProgress[share->share], &progress, __ATOMIC_RELAXED );
+	else
+		__atomic_store( &future->progress, &progress, __ATOMIC_RELAXED );
+
+	/* the submitting thread's function may be called from several workers at once */
+	if ( future->progressFunc && future->progressFunc( big_integer_async_progress( future ), future->progressContext ) )
+		__atomic_store_n( &future->cancelled, 1, __ATOMIC_RELAXED );
+
+	return __atomic_load_n( &future->cancelled, __ATOMIC_RELAXED );
+};
+
+void big_integer_async_unqueue_locked( BigIntegerFuture *future )
+{
+	BigIntegerFuture **link = &ASYNC_HEAD;
+	BigIntegerFuture *previous = NULL;
+	while ( *link != future )
+	{
+		previous = *link;
+		link = &(*link)->next;
+	}
+
+	*link = future->next;
+	if ( ASYNC_TAIL == future )
+		ASYNC_TAIL = previous;
+};
+
+void big_integer_async_cancel_locked( BigIntegerFuture *future )
+{
+	__atomic_store_n( &future->cancelled, 1, __ATOMIC_RELAXED );
+	if ( future->claimed == future->shares )
+		return;
+
+	/* the queued shares never run, the running ones stop at their next cancellation point */
+	big_integer_async_unqueue_locked( future );
+	future->claimed = future->shares;
+	if ( future->running == 0 )
+		big_integer_async_complete_locked( future );
+};
+
+/* called once all the shares of the future have run */
+void big_integer_async_complete_locked( BigIntegerFuture *future )
+{
+	/* operations without cancellation points only notice it at the end */
+	if ( __atomic_load_n( &future->cancelled, __ATOMIC_RELAXED ) )
+		future->status = BIG_INTEGER_CANCELLED;
+
+	if ( future->status == BIG_INTEGER_OK )
+	{
+		if ( future->operation == BIG_INTEGER_ASYNC_PRIME_BATCH )
+		{
+			int primes = 0;
+			int i;
+			for ( i = 0; i < future->count; ++i )
+				primes += future->results[i];
+			future->result = big_integer_create( primes );
+		}
+
+		double done = 1;
+		int i;
+		for ( i = 0; i < future->shares; ++i )
+			__atomic_store( &future->shareProgress[i], &done, __ATOMIC_RELAXED );
+		__atomic_store( &future->progress, &done, __ATOMIC_RELAXED );
+	}
+
+	big_integer_async_finish_locked( future );
+};
+
+void big_integer_async_finish_locked( BigIntegerFuture *future )
+{
+	__atomic_store_n( &future->state, BIG_INTEGER_ASYNC_DONE, __ATOMIC_RELEASE );
+	pthread_cond_broadcast( &ASYNC_FINISHED );
+	big_integer_async_release_locked( future );
+};
+
+void big_integer_async_release_locked( BigIntegerFuture *future )
+{
+	if ( --future->references == 0 )
+		big_integer_free( future );
+};
+
+BigIntegerFuture *big_integer_async_create( const BigIntegerAsyncOperation operation )
+{
+	/* in flag mode the submission returns NULL */
+	BigIntegerFuture *future = (BigIntegerFuture *) big_integer_allocate( sizeof(BigIntegerFuture) );
+	if ( !future )
+		return NULL;
+
+	future->operation = operation;
+	future->shares = 1;
+	big_integer_get_progress( &future->progressFunc, &future->progressContext );
+	return future;
+};
+
+BigIntegerFuture *big_integer_async_submit( BigIntegerFuture *future )
+{
+	pthread_mutex_lock( &ASYNC_LOCK );
+	if ( ASYNC_STOPPING ||
+		(ASYNC_THREADS_COUNT == 0 && big_integer_async_start_locked( BIG_INTEGER_ASYNC_DEFAULT_THREADS ) != 0) )
+	{
+		pthread_mutex_unlock( &ASYNC_LOCK );
+		big_integer_free( future );
+		return NULL;
+	}
+
+	future->result = big_integer_create( 0 );
+	future->status = BIG_INTEGER_OK;
+	future->state = BIG_INTEGER_ASYNC_PENDING;
+	future->cancelled = 0;
+	future->progress = 0;
+	future->claimed = 0;
+	future->running = 0;
+
+	int i;
+	for ( i = 0; i < future->shares; ++i )
+		future->shareProgress[i] = 0;
+	future->references = 2;
+	future->next = NULL;
+
+	if ( ASYNC_TAIL )
+		ASYNC_TAIL->next = future;
+	else
+		ASYNC_HEAD = future;
+	ASYNC_TAIL = future;
+
+	pthread_cond_signal( &ASYNC_QUEUED );
+	pthread_mutex_unlock( &ASYNC_LOCK );
+
+	return future;
+};
+
+
+/* PUBLIC FUNCTIONS IMPLEMENTATION */
+int big_integer_async_start( const int numThreads )
+{
+	pthread_mutex_lock( &ASYNC_LOCK );
+	int result = ( ASYNC_THREADS_COUNT > 0 ) ? 0 : big_integer_async_start_locked( numThreads );
+	pthread_mutex_unlock( &ASYNC_LOCK );
+
+	return result;
+};
+
+void big_integer_async_stop( )
+{
+	pthread_mutex_lock( &ASYNC_LOCK );
+	while ( ASYNC_HEAD )
+		big_integer_async_cancel_locked( ASYNC_HEAD );
+	ASYNC_STOPPING = 1;
+	pthread_cond_broadcast( &ASYNC_QUEUED );
+
+	int count = ASYNC_THREADS_COUNT;
+	pthread_mutex_unlock( &ASYNC_LOCK );
+
+	int i;
+	for ( i = 0; i < count; ++i )
+		pthread_join( ASYNC_THREADS[i], NULL );
+
+	pthread_mutex_lock( &ASYNC_LOCK );
+	ASYNC_THREADS_COUNT = 0;
+	ASYNC_STOPPING = 0;
+	pthread_mutex_unlock( &ASYNC_LOCK );
+};
+
+BigIntegerFuture *big_integer_async_multiply( const BigInteger left, const BigInteger right )
+{
+	BigIntegerFuture *future = big_integer_async_create( BIG_INTEGER_ASYNC_MULTIPLY );
+	if ( !future )
+		return NULL;
+
+	future->left = left;
+	future->right = right;
+	return big_integer_async_submit( future );
+};
+
+BigIntegerFuture *big_integer_async_pow_ui( const BigInteger base, const unsigned int exponent )
+{
+	BigIntegerFuture *future = big_integer_async_create( BIG_INTEGER_ASYNC_POW_UI );
+	if ( !future )
+		return NULL;
+
+	future->left = base;
+	future->exponent = exponent;
+	return big_integer_async_submit( future );
+};
+
+BigIntegerFuture *big_integer_async_next_prime( const BigInteger bigInt )
+{
+	BigIntegerFuture *future = big_integer_async_create( BIG_INTEGER_ASYNC_NEXT_PRIME );
+	if ( !future )
+		return NULL;
+
+	future->left = bigInt;
+	return big_integer_async_submit( future );
+};
+
+BigIntegerFuture *big_integer_async_is_probable_prime_batch( const BigInteger candidates[], int results[], const int count, const int rounds, const int numThreads )
+{
+	BigIntegerFuture *future = big_integer_async_create( BIG_INTEGER_ASYNC_PRIME_BATCH );
+	if ( !future )
+		return NULL;
+
+	future->candidates = candidates;
+	future->results = results;
+	future->count = count;
+	future->rounds = rounds;
+	future->shares = MAX( MIN( MIN( numThreads, BIG_INTEGER_MAX_THREADS ), count ), 1 );
+	return big_integer_async_submit( future );
+};
+
+BigIntegerAsyncState big_integer_async_poll( BigIntegerFuture *future )
+{
+	return __atomic_load_n( &future->state, __ATOMIC_ACQUIRE );
+};
+
+double big_integer_async_progress( BigIntegerFuture *future )
+{
+	double progress;
+	if ( future->operation != BIG_INTEGER_ASYNC_PRIME_BATCH )
+	{
+		__atomic_load( &future->progress, &progress, __ATOMIC_RELAXED );
+		return progress;
+	}
+
+	/* no share ever goes back, so neither does their sum */
+	double sum = 0;
+	int i;
+	for ( i = 0; i < future->shares; ++i )
+	{
+		__atomic_load( &future->shareProgress[i], &progress, __ATOMIC_RELAXED );
+		sum += progress;
+	}
+	return sum / future->shares;
+};
+
+BigIntegerStatus big_integer_async_wait( BigIntegerFuture *future, BigInteger *result )
+{
+	pthread_mutex_lock( &ASYNC_LOCK );
+	while ( future->state != BIG_INTEGER_ASYNC_DONE )
+		pthread_cond_wait( &ASYNC_FINISHED, &ASYNC_LOCK );
+	pthread_mutex_unlock( &ASYNC_LOCK );
+
+	if ( result && future->status == BIG_INTEGER_OK )
+		*result = future->result;
+
+	return future->status;
+};
+
+void big_integer_async_cancel( BigIntegerFuture *future )
+{
+	pthread_mutex_lock( &ASYNC_LOCK );
+	big_integer_async_cancel_locked( future );
+	pthread_mutex_unlock( &ASYNC_LOCK );
+};
+
+void big_integer_async_release( BigIntegerFuture *future )
+{
+	pthread_mutex_lock( &ASYNC_LOCK );
+	big_integer_async_release_locked( future );
+	pthread_mutex_unlock( &ASYNC_LOCK );
+};
@@ -0,0 +1,58 @@
+#ifndef BIG_INTEGER_ASYNC_H
+#define BIG_INTEGER_ASYNC_H
+
+/*
+** big_integer_async.h
+**     Description: Runs the long operations on a pool of worker threads and
+**                  returns futures to poll, wait for or cancel.
+**/
+
+#include "big_integer.h"
+
+#define BIG_INTEGER_ASYNC_DEFAULT_THREADS	4
+
+typedef enum BigIntegerAsyncState
+{
+	BIG_INTEGER_ASYNC_PENDING = 0,		/* waiting for a worker */
+	BIG_INTEGER_ASYNC_RUNNING,
+	BIG_INTEGER_ASYNC_DONE				/* finished, failed or cancelled, see big_integer_async_wait */
+} BigIntegerAsyncState;
+
+typedef struct BigIntegerFuture BigIntegerFuture;
+
+/* starts the pool with numThreads workers, if it isn't running. the first operation submitted
+   starts it with BIG_INTEGER_ASYNC_DEFAULT_THREADS otherwise. returns 0 on success, -1 otherwise */
+int big_integer_async_start( const int numThreads );
+
+/* cancels the queued operations, waits for the running ones and stops the workers */
+void big_integer_async_stop( );
+
+/* submit an operation. they return NULL if no worker can be started, or in flag mode if the
+   future can't be allocated (BIG_INTEGER_OUT_OF_MEMORY). the progress function of the
+   submitting thread, if any, is called from the workers with the future's progress */
+BigIntegerFuture *big_integer_async_multiply( const BigInteger left, const BigInteger right );
+BigIntegerFuture *big_integer_async_pow_ui( const BigInteger base, const unsigned int exponent );
+BigIntegerFuture *big_integer_async_next_prime( const BigInteger bigInt );
+
+/* splits the batch in numThreads shares, each run by one worker of the pool. the arrays must
+   stay valid until it is done. its result is the number of probable primes */
+BigIntegerFuture *big_integer_async_is_probable_prime_batch( const BigInteger candidates[], int results[], const int count, const int rounds, const int numThreads );
+
+/* returns the state of the operation without blocking */
+BigIntegerAsyncState big_integer_async_poll( BigIntegerFuture *future );
+
+/* returns the progress of the operation, from 0 to 1, or -1 when it isn't known */
+double big_integer_async_progress( BigIntegerFuture *future );
+
+/* blocks until the operation is done and returns its status. result, if not NULL,
+   receives the result when the status is BIG_INTEGER_OK */
+BigIntegerStatus big_integer_async_wait( BigIntegerFuture *future, BigInteger *result );
+
+/* asks the operation to stop. a queued one never runs, a running one stops at its next
+   cancellation point. either way its status becomes BIG_INTEGER_CANCELLED */
+void big_integer_async_cancel( BigIntegerFuture *future );
+
+/* frees the future. the operation goes on if it is still running */
+void big_integer_async_release( BigIntegerFuture *future );
+
+#endif /* BIG_INTEGER_ASYNC_H */
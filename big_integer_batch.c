@@ -0,0 +1,417 @@
+/*
+** big_integer_batch.c
+**     Description: Batches of same-size non-negative integers, stored as structure
+**                  of arrays so one operation runs on many elements at once.
+**                  Uses AVX2 when built with -mavx2, SSE2 when available, and
+**                  plain C otherwise or with -DBIG_INTEGER_BATCH_SCALAR.
+**/
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "macros.h"
+#include "big_integer_batch.h"
+#include "big_integer_internal.h"
+
+/* the vector kernels keep 32 bit lanes for carries and comparisons, and split
+   even and odd lanes into 64 bit halves for the multiplication */
+#if defined(BIG_INTEGER_BATCH_SCALAR)
+	/* the plain C kernels */
+#elif defined(__AVX2__)
+	#include <immintrin.h>
+	#define BATCH_VECTOR_LANES		8
+	typedef __m256i BatchVector;
+	#define BATCH_LOAD( p )			_mm256_loadu_si256( (const __m256i *)(p) )
+	#define BATCH_STORE( p, v )		_mm256_storeu_si256( (__m256i *)(p), (v) )
+	#define BATCH_ZERO( )			_mm256_setzero_si256( )
+	#define BATCH_SET1( x )			_mm256_set1_epi32( (int)(x) )
+	#define BATCH_ADD32( a, b )		_mm256_add_epi32( (a), (b) )
+	#define BATCH_SUB32( a, b )		_mm256_sub_epi32( (a), (b) )
+	#define BATCH_ADD64( a, b )		_mm256_add_epi64( (a), (b) )
+	#define BATCH_AND( a, b )		_mm256_and_si256( (a), (b) )
+	#define BATCH_OR( a, b )		_mm256_or_si256( (a), (b) )
+	#define BATCH_XOR( a, b )		_mm256_xor_si256( (a), (b) )
+	#define BATCH_CMPEQ32( a, b )	_mm256_cmpeq_epi32( (a), (b) )
+	#define BATCH_CMPGT32( a, b )	_mm256_cmpgt_epi32( (a), (b) )
+	#define BATCH_MUL_EVEN( a, b )	_mm256_mul_epu32( (a), (b) )
+	#define BATCH_SRL64( a, n )		_mm256_srli_epi64( (a), (n) )
+	#define BATCH_SLL64( a, n )		_mm256_slli_epi64( (a), (n) )
+#elif defined(__SSE2__)
+	#include <emmintrin.h>
+	#define BATCH_VECTOR_LANES		4
+	typedef __m128i BatchVector;
+	#define BATCH_LOAD( p )			_mm_loadu_si128( (const __m128i *)(p) )
+	#define BATCH_STORE( p, v )		_mm_storeu_si128( (__m128i *)(p), (v) )
+	#define BATCH_ZERO( )			_mm_setzero_si128( )
+	#define BATCH_SET1( x )			_mm_set1_epi32( (int)(x) )
+	#define BATCH_ADD32( a, b )		_mm_add_epi32( (a), (b) )
+	#define BATCH_SUB32( a, b )		_mm_sub_epi32( (a), (b) )
+	#define BATCH_ADD64( a, b )		_mm_add_epi64( (a), (b) )
+	#define BATCH_AND( a, b )		_mm_and_si128( (a), (b) )
+	#define BATCH_OR( a, b )		_mm_or_si128( (a), (b) )
+	#define BATCH_XOR( a, b )		_mm_xor_si128( (a), (b) )
+	#define BATCH_CMPEQ32( a, b )	_mm_cmpeq_epi32( (a), (b) )
+	#define BATCH_CMPGT32( a, b )	_mm_cmpgt_epi32( (a), (b) )
+	#define BATCH_MUL_EVEN( a, b )	_mm_mul_epu32( (a), (b) )
+	#define BATCH_SRL64( a, n )		_mm_srli_epi64( (a), (n) )
+	#define BATCH_SLL64( a, n )		_mm_slli_epi64( (a), (n) )
+#endif
+
+#ifdef BATCH_VECTOR_LANES
+	/* unsigned a < b, as all ones lanes */
+	#define BATCH_ULT32( a, b )		BATCH_CMPGT32( BATCH_XOR( (b), BATCH_SET1( 0x80000000u ) ), BATCH_XOR( (a), BATCH_SET1( 0x80000000u ) ) )
+#endif
+
+
+/* PRIVATE FUNCTIONS DECLARATIONS */
+unsigned int *big_integer_batch_limb( const BigIntegerBatch *batch, const int limb, const int element );
+
+
+/* PRIVATE FUNCTIONS IMPLEMENTATION */
+unsigned int *big_integer_batch_limb( const BigIntegerBatch *batch, const int limb, const int element )
+{
+	return batch->bits + (size_t) limb * batch->capacity + element;
+};
+
+
+/* PUBLIC FUNCTIONS IMPLEMENTATION */
+BigIntegerBatch big_integer_batch_create( const int count, const int length )
+{
+	BigIntegerBatch batch;
+	batch.count = count;
+	batch.length = length;
+	batch.capacity = (count + BIG_INTEGER_BATCH_LANES - 1) / BIG_INTEGER_BATCH_LANES * BIG_INTEGER_BATCH_LANES;
+	size_t size = sizeof(unsigned int) * MAX( batch.capacity * length, 1 );
+	batch.bits = (unsigned int *) big_integer_allocate( size );
+
+	/* in flag mode the batch is left empty */
+	if ( batch.bits )
+		memset( batch.bits, 0, size );
+	else
+		batch.count = batch.capacity = 0;
+
+	return batch;
+};
+
+void big_integer_batch_destroy( BigIntegerBatch *batch )
+{
+	if ( batch->bits )
+		big_integer_free( batch->bits );
+	batch->bits = NULL;
+	batch->count = 0;
+	batch->capacity = 0;
+};
+
+void big_integer_batch_load( BigIntegerBatch *batch, const BigInteger values[] )
+{
+	int i, j;
+	for ( j = 0; j < batch->count; ++j )
+	{
+		const BigInteger *value = &values[j];
+		int length = ( value->sign == 0 ) ? 0 : value->data.length;
+
+		/* in flag mode the element is loaded as zero */
+		if ( value->sign < 0 || length > batch->length )
+		{
+			big_integer_fail( value->sign < 0 ? BIG_INTEGER_INVALID_ARGUMENT : BIG_INTEGER_OVERFLOW );
+			length = 0;
+		}
+
+		for ( i = 0; i < batch->length; ++i )
+			*big_integer_batch_limb( batch, i, j ) = ( i < length ) ? value->data.bits[i] : 0;
+	}
+};
+
+void big_integer_batch_store( const BigIntegerBatch *batch, BigInteger values[] )
+{
+	int i, j;
+	for ( j = 0; j < batch->count; ++j )
+	{
+		BigInteger value = big_integer_create( 0 );
+		int length = 0;
+
+		for ( i = 0; i < batch->length; ++i )
+		{
+			unsigned int limb = *big_integer_batch_limb( batch, i, j );
+			if ( limb == 0 )
+				continue;
+
+			/* in flag mode the element is stored as zero */
+			if ( i >= BIG_INTEGER_DATA_MAX_SIZE )
+			{
+				big_integer_fail( BIG_INTEGER_OVERFLOW );
+				value = big_integer_create( 0 );
+				length = 0;
+				break;
+			}
+			value.data.bits[i] = limb;
+			length = i + 1;
+		}
+
+		if ( length > 0 )
+		{
+			value.sign = 1;
+			value.data.length = length;
+		}
+		values[j] = value;
+	}
+};
+
+void big_integer_batch_add( BigIntegerBatch *result, const BigIntegerBatch *left, const BigIntegerBatch *right, unsigned char carries[] )
+{
+#ifdef DEBUG
+	assert( left->count == right->count && left->count == result->count );
+	assert( left->length == right->length && left->length == result->length );
+#endif
+
+	int length = left->length;
+	int i, j;
+
+#ifdef BATCH_VECTOR_LANES
+	unsigned int lanes[BATCH_VECTOR_LANES];
+	int k;
+	for ( j = 0; j < left->capacity; j += BATCH_VECTOR_LANES )
+	{
+		/* carry lanes are all ones or zero */
+		BatchVector carry = BATCH_ZERO( );
+		for ( i = 0; i < length; ++i )
+		{
+			BatchVector a = BATCH_LOAD( big_integer_batch_limb( left, i, j ) );
+			BatchVector b = BATCH_LOAD( big_integer_batch_limb( right, i, j ) );
+			BatchVector sum = BATCH_ADD32( a, b );
+			BatchVector withCarry = BATCH_SUB32( sum, carry );
+
+			carry = BATCH_OR( BATCH_ULT32( sum, a ), BATCH_ULT32( withCarry, sum ) );
+			BATCH_STORE( big_integer_batch_limb( result, i, j ), withCarry );
+		}
+
+		if ( carries )
+		{
+			BATCH_STORE( lanes, carry );
+			for ( k = 0; k < BATCH_VECTOR_LANES && j + k < left->count; ++k )
+				carries[j+k] = lanes[k] & 1;
+		}
+	}
+#else
+	for ( j = 0; j < left->count; ++j )
+	{
+		unsigned long long carry = 0;
+		for ( i = 0; i < length; ++i )
+		{
+			carry += (unsigned long long) *big_integer_batch_limb( left, i, j ) + *big_integer_batch_limb( right, i, j );
+			*big_integer_batch_limb( result, i, j ) = (unsigned int) carry;
+			carry >>= UINT_NUM_BITS;
+		}
+
+		if ( carries )
+			carries[j] = (unsigned char) carry;
+	}
+#endif
+};
+
+void big_integer_batch_subtract( BigIntegerBatch *result, const BigIntegerBatch *left, const BigIntegerBatch *right, unsigned char borrows[] )
+{
+#ifdef DEBUG
+	assert( left->count == right->count && left->count == result->count );
+	assert( left->length == right->length && left->length == result->length );
+#endif
+
+	int length = left->length;
+	int i, j;
+
+#ifdef BATCH_VECTOR_LANES
+	unsigned int lanes[BATCH_VECTOR_LANES];
+	int k;
+	for ( j = 0; j < left->capacity; j += BATCH_VECTOR_LANES )
+	{
+		/* borrow lanes are all ones or zero */
+		BatchVector borrow = BATCH_ZERO( );
+		for ( i = 0; i < length; ++i )
+		{
+			BatchVector a = BATCH_LOAD( big_integer_batch_limb( left, i, j ) );
+			BatchVector b = BATCH_LOAD( big_integer_batch_limb( right, i, j ) );
+			BatchVector difference = BATCH_SUB32( a, b );
+			BatchVector withBorrow = BATCH_ADD32( difference, borrow );
+
+			borrow = BATCH_OR( BATCH_ULT32( a, b ), BATCH_ULT32( difference, withBorrow ) );
+			BATCH_STORE( big_integer_batch_limb( result, i, j ), withBorrow );
+		}
+
+		if ( borrows )
+		{
+			BATCH_STORE( lanes, borrow );
+			for ( k = 0; k < BATCH_VECTOR_LANES && j + k < left->count; ++k )
+				borrows[j+k] = lanes[k] & 1;
+		}
+	}
+#else
+	for ( j = 0; j < left->count; ++j )
+	{
+		unsigned long long borrow = 0;
+		for ( i = 0; i < length; ++i )
+		{
+			borrow = (unsigned long long) *big_integer_batch_limb( left, i, j ) - *big_integer_batch_limb( right, i, j ) - borrow;
+			*big_integer_batch_limb( result, i, j ) = (unsigned int) borrow;
+			borrow = (borrow >> UINT_NUM_BITS) & 1;
+		}
+
+		if ( borrows )
+			borrows[j] = (unsigned char) borrow;
+	}
+#endif
+};
+
+void big_integer_batch_compare( const BigIntegerBatch *left, const BigIntegerBatch *right, signed char results[] )
+{
+#ifdef DEBUG
+	assert( left->count == right->count && left->length == right->length );
+#endif
+
+	int i, j;
+
+#ifdef BATCH_VECTOR_LANES
+	int lanes[BATCH_VECTOR_LANES];
+	int k;
+	for ( j = 0; j < left->capacity; j += BATCH_VECTOR_LANES )
+	{
+		/* from the top limb down, the first difference decides each lane */
+		BatchVector compare = BATCH_ZERO( );
+		for ( i = left->length - 1; i >= 0; --i )
+		{
+			BatchVector a = BATCH_LOAD( big_integer_batch_limb( left, i, j ) );
+			BatchVector b = BATCH_LOAD( big_integer_batch_limb( right, i, j ) );
+			BatchVector undecided = BATCH_CMPEQ32( compare, BATCH_ZERO( ) );
+			BatchVector greater = BATCH_AND( BATCH_ULT32( b, a ), BATCH_SET1( 1 ) );
+			BatchVector less = BATCH_ULT32( a, b );
+
+			compare = BATCH_OR( compare, BATCH_AND( undecided, BATCH_OR( greater, less ) ) );
+		}
+
+		BATCH_STORE( lanes, compare );
+		for ( k = 0; k < BATCH_VECTOR_LANES && j + k < left->count; ++k )
+			results[j+k] = (signed char) lanes[k];
+	}
+#else
+	for ( j = 0; j < left->count; ++j )
+	{
+		results[j] = 0;
+		for ( i = left->length - 1; i >= 0; --i )
+		{
+			unsigned int a = *big_integer_batch_limb( left, i, j );
+			unsigned int b = *big_integer_batch_limb( right, i, j );
+			if ( a != b )
+			{
+				results[j] = ( a > b ) ? 1 : -1;
+				break;
+			}
+		}
+	}
+#endif
+};
+
+void big_integer_batch_multiply( BigIntegerBatch *result, const BigIntegerBatch *left, const BigIntegerBatch *right, unsigned char overflows[] )
+{
+#ifdef DEBUG
+	assert( left->count == right->count && left->count == result->count );
+#endif
+
+	/* the full product of one group of lanes, limb by limb */
+	int productLength = left->length + right->length;
+	unsigned int *product = (unsigned int *) big_integer_allocate( sizeof(unsigned int) * BIG_INTEGER_BATCH_LANES * MAX( productLength, 1 ) );
+	/* in flag mode every product is zero */
+	if ( !product )
+	{
+		memset( result->bits, 0, sizeof(unsigned int) * result->capacity * result->length );
+		if ( overflows )
+			memset( overflows, 0, (size_t) result->count );
+		return;
+	}
+
+	int i, j, k;
+
+#ifdef BATCH_VECTOR_LANES
+	/* each 64 bit half holds an even lane (low 32 bits) next to an odd lane (high 32 bits).
+	   a * b + product + carry <= (2^32 - 1)^2 + 2 * (2^32 - 1) = 2^64 - 1 */
+	BatchVector low = BATCH_SRL64( BATCH_SET1( 0xFFFFFFFFu ), 32 );
+	unsigned int lanes[BATCH_VECTOR_LANES];
+
+	for ( j = 0; j < left->capacity; j += BATCH_VECTOR_LANES )
+	{
+		memset( product, 0, sizeof(unsigned int) * BATCH_VECTOR_LANES * productLength );
+
+		for ( i = 0; i < left->length; ++i )
+		{
+			BatchVector a = BATCH_LOAD( big_integer_batch_limb( left, i, j ) );
+			BatchVector aOdd = BATCH_SRL64( a, 32 );
+			BatchVector carryEven = BATCH_ZERO( );
+			BatchVector carryOdd = BATCH_ZERO( );
+
+			for ( k = 0; k < right->length; ++k )
+			{
+				BatchVector b = BATCH_LOAD( big_integer_batch_limb( right, k, j ) );
+				BatchVector r = BATCH_LOAD( product + (i + k) * BATCH_VECTOR_LANES );
+
+				BatchVector even = BATCH_ADD64( BATCH_ADD64( BATCH_MUL_EVEN( a, b ), BATCH_AND( r, low ) ), carryEven );
+				BatchVector odd = BATCH_ADD64( BATCH_ADD64( BATCH_MUL_EVEN( aOdd, BATCH_SRL64( b, 32 ) ), BATCH_SRL64( r, 32 ) ), carryOdd );
+
+				BATCH_STORE( product + (i + k) * BATCH_VECTOR_LANES, BATCH_OR( BATCH_AND( even, low ), BATCH_SLL64( odd, 32 ) ) );
+				carryEven = BATCH_SRL64( even, 32 );
+				carryOdd = BATCH_SRL64( odd, 32 );
+			}
+
+			BATCH_STORE( product + (i + right->length) * BATCH_VECTOR_LANES, BATCH_OR( carryEven, BATCH_SLL64( carryOdd, 32 ) ) );
+		}
+
+		BatchVector overflow = BATCH_ZERO( );
+		for ( i = 0; i < productLength; ++i )
+		{
+			BatchVector limb = BATCH_LOAD( product + i * BATCH_VECTOR_LANES );
+			if ( i < result->length )
+				BATCH_STORE( big_integer_batch_limb( result, i, j ), limb );
+			else
+				overflow = BATCH_OR( overflow, limb );
+		}
+		for ( ; i < result->length; ++i )
+			BATCH_STORE( big_integer_batch_limb( result, i, j ), BATCH_ZERO( ) );
+
+		if ( overflows )
+		{
+			BATCH_STORE( lanes, overflow );
+			for ( k = 0; k < BATCH_VECTOR_LANES && j + k < left->count; ++k )
+				overflows[j+k] = lanes[k] != 0;
+		}
+	}
+#else
+	for ( j = 0; j < left->count; ++j )
+	{
+		memset( product, 0, sizeof(unsigned int) * productLength );
+
+		for ( i = 0; i < left->length; ++i )
+		{
+			unsigned long long carry = 0;
+			for ( k = 0; k < right->length; ++k )
+			{
+				carry += (unsigned long long) *big_integer_batch_limb( left, i, j ) * *big_integer_batch_limb( right, k, j ) + product[i+k];
+				product[i+k] = (unsigned int) carry;
+				carry >>= UINT_NUM_BITS;
+			}
+			product[i + right->length] = (unsigned int) carry;
+		}
+
+		unsigned int overflow = 0;
+		for ( i = 0; i < MAX( productLength, result->length ); ++i )
+		{
+			unsigned int limb = ( i < productLength ) ? product[i] : 0;
+			if ( i < result->length )
+				*big_integer_batch_limb( result, i, j ) = limb;
+			else
+				overflow |= limb;
+		}
+
+		if ( overflows )
+			overflows[j] = overflow != 0;
+	}
+#endif
+
+	big_integer_free( product );
+};
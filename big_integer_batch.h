@@ -0,0 +1,54 @@
+#ifndef BIG_INTEGER_BATCH_H
+#define BIG_INTEGER_BATCH_H
+
+/*
+** big_integer_batch.h
+**     Description: Batches of same-size non-negative integers, stored as structure
+**                  of arrays so one operation runs on many elements at once.
+**                  Uses AVX2 when built with -mavx2, SSE2 when available, and
+**                  plain C otherwise or with -DBIG_INTEGER_BATCH_SCALAR.
+**/
+
+#include "big_integer.h"
+
+/* elements are padded to a multiple of this, so the kernels never handle a tail */
+#define BIG_INTEGER_BATCH_LANES		8
+
+typedef struct BigIntegerBatch
+{
+	unsigned int *bits;		/* limb i of element j is bits[i * capacity + j] */
+	int count;				/* number of elements */
+	int capacity;			/* count rounded up to BIG_INTEGER_BATCH_LANES */
+	int length;				/* limbs per element */
+} BigIntegerBatch;
+
+/* creates a batch of count zeros with length limbs each. in flag mode a failed
+   allocation gives an empty batch */
+BigIntegerBatch big_integer_batch_create( const int count, const int length );
+
+/* frees the memory of the batch */
+void big_integer_batch_destroy( BigIntegerBatch *batch );
+
+/* copies count non-negative values of at most batch->length limbs into the batch. a negative
+   value is an invalid argument, a longer one an overflow, and either is loaded as zero in flag mode */
+void big_integer_batch_load( BigIntegerBatch *batch, const BigInteger values[] );
+
+/* copies the elements of the batch out to values */
+void big_integer_batch_store( const BigIntegerBatch *batch, BigInteger values[] );
+
+/* result = left + right modulo 2^(32 * length) for every element. all batches have the same
+   count and length. if carries is not NULL, it receives the carry out of each element */
+void big_integer_batch_add( BigIntegerBatch *result, const BigIntegerBatch *left, const BigIntegerBatch *right, unsigned char carries[] );
+
+/* result = left - right modulo 2^(32 * length) for every element. all batches have the same
+   count and length. if borrows is not NULL, it receives 1 for each element where left < right */
+void big_integer_batch_subtract( BigIntegerBatch *result, const BigIntegerBatch *left, const BigIntegerBatch *right, unsigned char borrows[] );
+
+/* results receives -1, 0 or 1 comparing every element. both batches have the same count and length */
+void big_integer_batch_compare( const BigIntegerBatch *left, const BigIntegerBatch *right, signed char results[] );
+
+/* result = left * right modulo 2^(32 * result->length) for every element. all batches have
+   the same count. if overflows is not NULL, it receives 1 for each product that didn't fit */
+void big_integer_batch_multiply( BigIntegerBatch *result, const BigIntegerBatch *left, const BigIntegerBatch *right, unsigned char overflows[] );
+
+#endif /* BIG_INTEGER_BATCH_H */
@@ -0,0 +1,147 @@
+/*
+** big_integer_counter.c
+**     Description: Counter shared by many threads, for totals that don't fit in
+**                  64 bits.
+**/
+
+#include <string.h>
+#include "big_integer_counter.h"
+#include "big_integer_internal.h"
+
+#define COUNTER_SPILL	(1ULL << 63)
+
+/* each thread adds to the shard of its index, threads beyond the shard count share them */
+__thread int THREAD_COUNTER_SHARD = -1;
+int COUNTER_THREADS = 0;
+
+
+/* PRIVATE FUNCTIONS DECLARATIONS */
+BigIntegerCounterShard *big_integer_counter_shard( BigIntegerCounter *counter );
+void big_integer_counter_spill( BigIntegerCounterShard *shard, const int fromLow );
+BigInteger big_integer_counter_create( const unsigned long long value );
+
+
+/* PRIVATE FUNCTIONS IMPLEMENTATION */
+BigIntegerCounterShard *big_integer_counter_shard( BigIntegerCounter *counter )
+{
+	if ( THREAD_COUNTER_SHARD < 0 )
+		THREAD_COUNTER_SHARD = __atomic_fetch_add( &COUNTER_THREADS, 1, __ATOMIC_RELAXED ) % BIG_INTEGER_COUNTER_SHARDS;
+
+	return &counter->shards[THREAD_COUNTER_SHARD];
+};
+
+/* adds 2^63 to high, taking it from low if fromLow. the sequence doubles as the lock of the writers */
+void big_integer_counter_spill( BigIntegerCounterShard *shard, const int fromLow )
+{
+	unsigned int sequence;
+	for (;;)
+	{
+		sequence = __atomic_load_n( &shard->sequence, __ATOMIC_RELAXED );
+		if ( (sequence & 1) == 0 &&
+			__atomic_compare_exchange_n( &shard->sequence, &sequence, sequence + 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) )
+			break;
+	}
+	/* the odd sequence is visible before any store below, pairs with the acquire fence of the readers */
+	__atomic_thread_fence( __ATOMIC_RELEASE );
+
+	/* several threads may see low at 2^63 or more, only the first to lock the shard moves it */
+	if ( !fromLow || __atomic_load_n( &shard->low, __ATOMIC_RELAXED ) >= COUNTER_SPILL )
+	{
+		/* readers retry while the sequence is odd, so they never see only half of the move */
+		BigIntegerData high = shard->high;
+		big_integer_increment_data( &high, 1 );
+
+		int i;
+		for ( i = 0; i < BIG_INTEGER_DATA_MAX_SIZE; ++i )
+			__atomic_store_n( &shard->high.bits[i], high.bits[i], __ATOMIC_RELAXED );
+		__atomic_store_n( &shard->high.length, high.length, __ATOMIC_RELAXED );
+		if ( fromLow )
+			__atomic_fetch_sub( &shard->low, COUNTER_SPILL, __ATOMIC_RELAXED );
+	}
+
+	__atomic_store_n( &shard->sequence, sequence + 2, __ATOMIC_RELEASE );
+};
+
+BigInteger big_integer_counter_create( const unsigned long long value )
+{
+	BigInteger bigInt = big_integer_create( 0 );
+	if ( value == 0 )
+		return bigInt;
+
+	bigInt.sign = 1;
+	bigInt.data.bits[0] = (unsigned int) value;
+	bigInt.data.bits[1] = (unsigned int) (value >> 32);
+	bigInt.data.length = ( bigInt.data.bits[1] != 0 ) ? 2 : 1;
+
+	return bigInt;
+};
+
+
+/* PUBLIC FUNCTIONS IMPLEMENTATION */
+void big_integer_counter_init( BigIntegerCounter *counter )
+{
+	memset( counter, 0, sizeof(BigIntegerCounter) );
+};
+
+void big_integer_counter_add( BigIntegerCounter *counter, const unsigned long long amount )
+{
+	BigIntegerCounterShard *shard = big_integer_counter_shard( counter );
+	unsigned long long rest = amount;
+
+	if ( rest >= COUNTER_SPILL )
+	{
+		rest -= COUNTER_SPILL;
+		big_integer_counter_spill( shard, 0 );
+	}
+
+	/* adds only while low is below 2^63, and rest is too, so low never wraps however many
+	   threads share the shard. a thread that finds a pending spill does it itself */
+	unsigned long long old = __atomic_load_n( &shard->low, __ATOMIC_RELAXED );
+	for (;;)
+	{
+		if ( old >= COUNTER_SPILL )
+		{
+			big_integer_counter_spill( shard, 1 );
+			old = __atomic_load_n( &shard->low, __ATOMIC_RELAXED );
+		}
+		else if ( __atomic_compare_exchange_n( &shard->low, &old, old + rest, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+			break;
+	}
+
+	if ( old + rest >= COUNTER_SPILL )
+		big_integer_counter_spill( shard, 1 );
+};
+
+BigInteger big_integer_counter_read( BigIntegerCounter *counter )
+{
+	BigInteger high = big_integer_create( 0 );
+	BigInteger low = big_integer_create( 0 );
+	int i, j;
+
+	for ( i = 0; i < BIG_INTEGER_COUNTER_SHARDS; ++i )
+	{
+		BigIntegerCounterShard *shard = &counter->shards[i];
+		BigInteger shardHigh;
+		unsigned long long shardLow;
+		unsigned int sequence;
+
+		/* a seqlock read, low is added to without a new sequence but each add is atomic */
+		do
+		{
+			sequence = __atomic_load_n( &shard->sequence, __ATOMIC_ACQUIRE );
+			for ( j = 0; j < BIG_INTEGER_DATA_MAX_SIZE; ++j )
+				shardHigh.data.bits[j] = __atomic_load_n( &shard->high.bits[j], __ATOMIC_RELAXED );
+			shardHigh.data.length = __atomic_load_n( &shard->high.length, __ATOMIC_RELAXED );
+			shardLow = __atomic_load_n( &shard->low, __ATOMIC_RELAXED );
+			__atomic_thread_fence( __ATOMIC_ACQUIRE );
+		} while ( (sequence & 1) || sequence != __atomic_load_n( &shard->sequence, __ATOMIC_RELAXED ) );
+
+		shardHigh.sign = ( shardHigh.data.length > 0 ) ? 1 : 0;
+		high = big_integer_add( high, shardHigh );
+		low = big_integer_add( low, big_integer_counter_create( shardLow ) );
+	}
+
+	/* high * 2^63 + low */
+	high = big_integer_multiply( high, big_integer_counter_create( COUNTER_SPILL ) );
+	return big_integer_add( high, low );
+};
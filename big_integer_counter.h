@@ -0,0 +1,38 @@
+#ifndef BIG_INTEGER_COUNTER_H
+#define BIG_INTEGER_COUNTER_H
+
+/*
+** big_integer_counter.h
+**     Description: Counter shared by many threads, for totals that don't fit in
+**                  64 bits. Each thread adds to its own shard without locks, a read
+**                  combines the shards.
+**/
+
+#include "big_integer.h"
+
+#define BIG_INTEGER_COUNTER_SHARDS	64
+
+/* one cache line per shard, so threads don't share them */
+typedef struct BigIntegerCounterShard
+{
+	unsigned long long low;		/* below 2^63 except while a spill is pending, never wraps */
+	unsigned int sequence;		/* odd while the shard is spilling low into high */
+	BigIntegerData high;		/* number of 2^63 spilled */
+} __attribute__(( aligned( 64 ) )) BigIntegerCounterShard;
+
+typedef struct BigIntegerCounter
+{
+	BigIntegerCounterShard shards[BIG_INTEGER_COUNTER_SHARDS];
+} BigIntegerCounter;
+
+/* sets the counter to zero. it must not be in use */
+void big_integer_counter_init( BigIntegerCounter *counter );
+
+/* adds amount to the counter, from any thread */
+void big_integer_counter_add( BigIntegerCounter *counter, const unsigned long long amount );
+
+/* returns the total. while other threads add, it is between the totals at the
+   start and at the end of the read */
+BigInteger big_integer_counter_read( BigIntegerCounter *counter );
+
+#endif /* BIG_INTEGER_COUNTER_H */
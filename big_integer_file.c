@@ -0,0 +1,281 @@
+/*
+** big_integer_file.c
+**     Description: On-disk format for integers of any length, mapped straight
+**                  into memory when read.
+**/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "big_integer_file.h"
+#include "big_integer_internal.h"
+
+#define BIG_INTEGER_FILE_VERSION		1
+#define BIG_INTEGER_FILE_LITTLE_ENDIAN	1
+#define BIG_INTEGER_FILE_BIG_ENDIAN		2
+
+const unsigned char BIG_INTEGER_FILE_MAGIC[4] = { 'B', 'I', 'G', 'I' };
+
+
+/* PRIVATE FUNCTIONS DECLARATIONS */
+int big_integer_file_native_order( );
+unsigned int big_integer_file_swap( const unsigned int value );
+int big_integer_file_write_header( FILE *file, const char sign, const unsigned long long length );
+
+
+/* PRIVATE FUNCTIONS IMPLEMENTATION */
+int big_integer_file_native_order( )
+{
+	unsigned int probe = 1;
+	return ( *(unsigned char *) &probe == 1 ) ? BIG_INTEGER_FILE_LITTLE_ENDIAN : BIG_INTEGER_FILE_BIG_ENDIAN;
+};
+
+unsigned int big_integer_file_swap( const unsigned int value )
+{
+	return (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+};
+
+int big_integer_file_write_header( FILE *file, const char sign, const unsigned long long length )
+{
+	unsigned char header[BIG_INTEGER_FILE_HEADER_SIZE];
+	int i;
+
+	memcpy( header, BIG_INTEGER_FILE_MAGIC, 4 );
+	header[4] = BIG_INTEGER_FILE_VERSION;
+	header[5] = (unsigned char) sign;
+	header[6] = sizeof(unsigned int);
+	header[7] = (unsigned char) big_integer_file_native_order( );
+	for ( i = 0; i < 8; ++i )
+		header[8+i] = (unsigned char) (length >> (8 * i));
+
+	if ( fseek( file, 0, SEEK_SET ) != 0 )
+		return -1;
+
+	return fwrite( header, 1, sizeof(header), file ) == sizeof(header) ? 0 : -1;
+};
+
+
+/* PUBLIC FUNCTIONS IMPLEMENTATION */
+int big_integer_map_file( const char *path, BigIntegerMapping *mapping )
+{
+	struct stat status;
+	int fd = open( path, O_RDONLY );
+	if ( fd < 0 )
+		return -1;
+
+	if ( fstat( fd, &status ) != 0 || status.st_size < BIG_INTEGER_FILE_HEADER_SIZE )
+	{
+		close( fd );
+		return -1;
+	}
+
+	size_t size = (size_t) status.st_size;
+	void *address = mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	close( fd );
+	if ( address == MAP_FAILED )
+		return -1;
+
+	const unsigned char *header = (const unsigned char *) address;
+	signed char sign = (signed char) header[5];
+	unsigned long long length = 0;
+	int i;
+	for ( i = 7; i >= 0; --i )
+		length = (length << 8) | header[8+i];
+
+	if ( memcmp( header, BIG_INTEGER_FILE_MAGIC, 4 ) != 0 ||
+		header[4] != BIG_INTEGER_FILE_VERSION ||
+		header[6] != sizeof(unsigned int) ||
+		(header[7] != BIG_INTEGER_FILE_LITTLE_ENDIAN && header[7] != BIG_INTEGER_FILE_BIG_ENDIAN) ||
+		sign < -1 || sign > 1 ||
+		length != (size - BIG_INTEGER_FILE_HEADER_SIZE) / sizeof(unsigned int) ||
+		(size - BIG_INTEGER_FILE_HEADER_SIZE) % sizeof(unsigned int) != 0 )
+	{
+		munmap( address, size );
+		return -1;
+	}
+
+	mapping->address = address;
+	mapping->size = size;
+	mapping->bits = (const unsigned int *) (header + BIG_INTEGER_FILE_HEADER_SIZE);
+	mapping->length = (size_t) length;
+	mapping->sign = sign;
+	mapping->swapped = header[7] != big_integer_file_native_order( );
+
+	/* streams may have written leading zeros */
+	while ( mapping->length > 0 && mapping->bits[mapping->length-1] == 0 )
+		mapping->length--;
+
+	if ( mapping->length == 0 )
+		mapping->sign = 0;
+	else if ( mapping->sign == 0 )
+	{
+		big_integer_unmap_file( mapping );
+		return -1;
+	}
+
+	return 0;
+};
+
+void big_integer_unmap_file( BigIntegerMapping *mapping )
+{
+	if ( mapping->address )
+		munmap( mapping->address, mapping->size );
+
+	mapping->address = NULL;
+	mapping->bits = NULL;
+	mapping->size = 0;
+	mapping->length = 0;
+	mapping->sign = 0;
+};
+
+unsigned int big_integer_mapping_limb( const BigIntegerMapping *mapping, const size_t i )
+{
+	unsigned int limb = mapping->bits[i];
+	return mapping->swapped ? big_integer_file_swap( limb ) : limb;
+};
+
+BigInteger big_integer_mapping_value( const BigIntegerMapping *mapping )
+{
+	BigInteger bigInt = big_integer_create( 0 );
+	if ( mapping->sign == 0 )
+		return bigInt;
+
+	if ( mapping->length > BIG_INTEGER_DATA_MAX_SIZE )
+	{
+		big_integer_fail( BIG_INTEGER_OVERFLOW );
+		return bigInt;
+	}
+
+	size_t i;
+	for ( i = 0; i < mapping->length; ++i )
+		bigInt.data.bits[i] = big_integer_mapping_limb( mapping, i );
+	bigInt.data.length = (int) mapping->length;
+	bigInt.sign = mapping->sign;
+
+	return bigInt;
+};
+
+int big_integer_mapping_compare( const BigIntegerMapping *mapping, const BigInteger bigInt )
+{
+	if ( mapping->sign > bigInt.sign )
+		return 1;
+	if ( mapping->sign < bigInt.sign )
+		return -1;
+
+	/* if they have the same sign */
+	char sign = mapping->sign;
+	if ( mapping->length != (size_t) bigInt.data.length )
+		return sign * ( mapping->length > (size_t) bigInt.data.length ? 1 : -1 );
+
+	size_t i;
+	for ( i = mapping->length; i > 0; --i )
+	{
+		unsigned int limb = big_integer_mapping_limb( mapping, i - 1 );
+		if ( limb > bigInt.data.bits[i-1] )
+			return sign;
+		if ( limb < bigInt.data.bits[i-1] )
+			return -sign;
+	}
+
+	return 0;
+};
+
+unsigned int big_integer_mapping_mod_divisor( const BigIntegerMapping *mapping, const BigIntegerDivisor *divisor )
+{
+	/* the limbs are divided from the top in chunks, each with the remainder of the previous one
+	   as its top limb. that limb is less than the divisor, as big_integer_divmod_data_preinv needs */
+	BigIntegerData chunk;
+	unsigned int remainder = 0;
+	size_t end = mapping->length;
+	while ( end > 0 )
+	{
+		size_t start = ( end > BIG_INTEGER_DATA_MAX_SIZE - 1 ) ? end - (BIG_INTEGER_DATA_MAX_SIZE - 1) : 0;
+		int j;
+		for ( j = 0; j < (int) (end - start); ++j )
+			chunk.bits[j] = big_integer_mapping_limb( mapping, start + j );
+		chunk.bits[j] = remainder;
+		chunk.length = j + 1;
+
+		remainder = big_integer_divmod_data_preinv( &chunk, divisor );
+		end = start;
+	}
+
+	if ( mapping->sign < 0 && remainder > 0 )
+		return divisor->value - remainder;
+
+	return remainder;
+};
+
+int big_integer_write_file( const char *path, const BigInteger bigInt )
+{
+	BigIntegerFileWriter writer;
+	if ( big_integer_file_writer_open( &writer, path, bigInt.sign ) != 0 )
+		return -1;
+
+	if ( bigInt.sign != 0 && big_integer_file_writer_append( &writer, bigInt.data.bits, (size_t) bigInt.data.length ) != 0 )
+	{
+		big_integer_file_writer_close( &writer );
+		remove( path );
+		return -1;
+	}
+
+	if ( big_integer_file_writer_close( &writer ) != 0 )
+	{
+		remove( path );
+		return -1;
+	}
+
+	return 0;
+};
+
+int big_integer_file_writer_open( BigIntegerFileWriter *writer, const char *path, const char sign )
+{
+	writer->length = 0;
+	writer->sign = sign;
+	writer->file = fopen( path, "wb" );
+	if ( !writer->file )
+		return -1;
+
+	/* the length is only known at the end */
+	if ( big_integer_file_write_header( writer->file, sign, 0 ) != 0 )
+	{
+		fclose( writer->file );
+		writer->file = NULL;
+		remove( path );
+		return -1;
+	}
+
+	return 0;
+};
+
+int big_integer_file_writer_append( BigIntegerFileWriter *writer, const unsigned int bits[], const size_t count )
+{
+	if ( fwrite( bits, sizeof(unsigned int), count, writer->file ) != count )
+		return -1;
+
+	writer->length += count;
+	return 0;
+};
+
+int big_integer_file_writer_close( BigIntegerFileWriter *writer )
+{
+	int result;
+
+	/* the open failed or the writer was already closed */
+	if ( !writer->file )
+		return -1;
+
+	result = big_integer_file_write_header( writer->file, writer->sign, writer->length );
+
+	if ( fclose( writer->file ) != 0 )
+		result = -1;
+	writer->file = NULL;
+
+	return result;
+};
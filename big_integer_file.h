@@ -0,0 +1,73 @@
+#ifndef BIG_INTEGER_FILE_H
+#define BIG_INTEGER_FILE_H
+
+/*
+** big_integer_file.h
+**     Description: On-disk format for integers of any length, mapped straight
+**                  into memory when read.
+**
+**     Layout: a 16 byte header followed by the raw limbs, least significant first.
+**         0  "BIGI"
+**         4  format version (1)
+**         5  sign (-1, 0 or 1)
+**         6  bytes per limb (4)
+**         7  byte order of the limbs (1 little endian, 2 big endian)
+**         8  number of limbs, 64 bit little endian
+**/
+
+#include <stdio.h>
+#include <stddef.h>
+#include "big_integer.h"
+
+#define BIG_INTEGER_FILE_HEADER_SIZE	16
+
+/* a read-only mapping of a file */
+typedef struct BigIntegerMapping
+{
+	const unsigned int *bits;	/* the limbs, in the byte order of the file */
+	size_t length;				/* number of limbs, without leading zeros */
+	char sign;
+	int swapped;				/* the file byte order isn't the native one */
+	void *address;
+	size_t size;
+} BigIntegerMapping;
+
+/* writes limbs to a file as they are computed, least significant first */
+typedef struct BigIntegerFileWriter
+{
+	FILE *file;
+	unsigned long long length;
+	char sign;
+} BigIntegerFileWriter;
+
+/* maps the file read-only. returns 0 on success, -1 if it can't be mapped or isn't valid */
+int big_integer_map_file( const char *path, BigIntegerMapping *mapping );
+
+/* releases the mapping */
+void big_integer_unmap_file( BigIntegerMapping *mapping );
+
+/* returns limb i of the mapping in native byte order */
+unsigned int big_integer_mapping_limb( const BigIntegerMapping *mapping, const size_t i );
+
+/* returns the mapped value as a BigInteger, reporting overflow if it doesn't fit */
+BigInteger big_integer_mapping_value( const BigIntegerMapping *mapping );
+
+/* compares the mapped value with a big integer, without copying it */
+int big_integer_mapping_compare( const BigIntegerMapping *mapping, const BigInteger bigInt );
+
+/* returns the mapped value modulo divisor, in the range [0, divisor), without copying it */
+unsigned int big_integer_mapping_mod_divisor( const BigIntegerMapping *mapping, const BigIntegerDivisor *divisor );
+
+/* writes the big integer to a file. returns 0 on success, -1 otherwise, in which case no file is left at path */
+int big_integer_write_file( const char *path, const BigInteger bigInt );
+
+/* creates the file, with the sign of the value to be written. returns 0 on success, -1 otherwise, in which case no file is left at path */
+int big_integer_file_writer_open( BigIntegerFileWriter *writer, const char *path, const char sign );
+
+/* appends the next count limbs. returns 0 on success, -1 otherwise */
+int big_integer_file_writer_append( BigIntegerFileWriter *writer, const unsigned int bits[], const size_t count );
+
+/* writes the final length into the header and closes the file. returns 0 on success, -1 on failure or if the writer isn't open. a file left incomplete by a failed append or close isn't removed */
+int big_integer_file_writer_close( BigIntegerFileWriter *writer );
+
+#endif /* BIG_INTEGER_FILE_H */
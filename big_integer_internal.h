@@ -0,0 +1,28 @@
+#ifndef BIG_INTEGER_INTERNAL_H
+#define BIG_INTEGER_INTERNAL_H
+
+/*
+** big_integer_internal.h
+**     Description: Functions of big_integer.c shared with the other modules of
+**                  the library. They aren't part of the public interface.
+**/
+
+#include "big_integer.h"
+
+/* bits in a limb */
+extern const int UINT_NUM_BITS;
+
+/* records status as the calling thread's error and aborts in abort mode. returns 1 otherwise */
+int big_integer_fail( const BigIntegerStatus status );
+
+/* allocates through the memory functions, reporting BIG_INTEGER_OUT_OF_MEMORY when it fails */
+void *big_integer_allocate( const size_t size );
+void big_integer_free( void *pointer );
+
+/* adds value to the data in place */
+void big_integer_increment_data( BigIntegerData *pBigIntData, const unsigned int value );
+
+/* divides pBigIntData in place and returns the remainder */
+unsigned int big_integer_divmod_data_preinv( BigIntegerData *pBigIntData, const BigIntegerDivisor *pDivisor );
+
+#endif /* BIG_INTEGER_INTERNAL_H */
@@ -0,0 +1,61 @@
+/*
+** big_integer_shared.c
+**     Description: Immutable big integers shared by reference between threads.
+**/
+
+#include "big_integer_shared.h"
+#include "big_integer_internal.h"
+
+
+/* PUBLIC FUNCTIONS IMPLEMENTATION */
+BigIntegerShared *big_integer_shared_create( const BigInteger bigInt )
+{
+	BigIntegerShared *shared = (BigIntegerShared *) big_integer_allocate( sizeof(BigIntegerShared) );
+	if ( !shared )
+		return NULL;
+
+	shared->references = 1;
+	shared->value = bigInt;
+	return shared;
+};
+
+BigIntegerShared *big_integer_shared_acquire( BigIntegerShared *shared )
+{
+	/* the caller already holds a reference, so no ordering is needed to take another */
+	__atomic_add_fetch( &shared->references, 1, __ATOMIC_RELAXED );
+	return shared;
+};
+
+void big_integer_shared_release( BigIntegerShared *shared )
+{
+	/* the release makes this thread's reads happen before the free in the last one */
+	if ( __atomic_sub_fetch( &shared->references, 1, __ATOMIC_ACQ_REL ) == 0 )
+		big_integer_free( shared );
+};
+
+const BigInteger *big_integer_shared_get( const BigIntegerShared *shared )
+{
+	return &shared->value;
+};
+
+int big_integer_shared_references( const BigIntegerShared *shared )
+{
+	return __atomic_load_n( &shared->references, __ATOMIC_ACQUIRE );
+};
+
+BigInteger *big_integer_shared_mutate( BigIntegerShared **shared )
+{
+	/* being the only holder, no other thread can take a new reference */
+	if ( big_integer_shared_references( *shared ) == 1 )
+		return &(*shared)->value;
+
+	/* the caller keeps its reference to the old value when the copy fails */
+	BigIntegerShared *copy = big_integer_shared_create( (*shared)->value );
+	if ( !copy )
+		return NULL;
+
+	big_integer_shared_release( *shared );
+	*shared = copy;
+
+	return &copy->value;
+};
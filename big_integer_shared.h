@@ -0,0 +1,40 @@
+#ifndef BIG_INTEGER_SHARED_H
+#define BIG_INTEGER_SHARED_H
+
+/*
+** big_integer_shared.h
+**     Description: Immutable big integers shared by reference between threads.
+**                  Readers never copy nor lock, a writer copies the value only
+**                  when someone else still holds it.
+**/
+
+#include "big_integer.h"
+
+typedef struct BigIntegerShared
+{
+	int references;			/* updated atomically, don't touch */
+	BigInteger value;
+} BigIntegerShared;
+
+/* creates a shared copy of bigInt held once by the caller. in flag mode it returns NULL
+   when the copy can't be allocated (BIG_INTEGER_OUT_OF_MEMORY) */
+BigIntegerShared *big_integer_shared_create( const BigInteger bigInt );
+
+/* takes one more reference to shared, which may be passed to another thread. returns shared */
+BigIntegerShared *big_integer_shared_acquire( BigIntegerShared *shared );
+
+/* drops one reference, freeing the value when it was the last one */
+void big_integer_shared_release( BigIntegerShared *shared );
+
+/* returns the value, valid while the reference is held. it must not be modified */
+const BigInteger *big_integer_shared_get( const BigIntegerShared *shared );
+
+/* returns the number of references currently held */
+int big_integer_shared_references( const BigIntegerShared *shared );
+
+/* returns the value to be modified in place. if other references exist, *shared is first
+   replaced by a private copy and the caller's reference to the old value is released. in flag
+   mode it returns NULL when the copy can't be allocated, leaving *shared as it was */
+BigInteger *big_integer_shared_mutate( BigIntegerShared **shared );
+
+#endif /* BIG_INTEGER_SHARED_H */
@@ -0,0 +1,908 @@
+/*
+** big_integer_fuzz.c
+**     Description: Differential fuzz target for big_integer.c. Every operation is
+**                  checked against big_integer_reference.c, and against __int128
+**                  when the operands are small.
+**
+**     libFuzzer: clang -fsanitize=fuzzer -DBIG_INTEGER_LIBFUZZER ...
+**     AFL:       make fuzz CC=afl-gcc, then afl-fuzz ... -- ./bigint_fuzz
+**     Random:    ./bigint_fuzz -random <iterations> [seed]
+**/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include "macros.h"
+#include "big_integer.h"
+#include "big_integer_batch.h"
+#include "big_integer_reference.h"
+
+#define FUZZ_MAX_INPUT_SIZE		4096
+
+typedef enum FuzzOperation
+{
+	FUZZ_ADD,
+	FUZZ_SUBTRACT,
+	FUZZ_COMPARE,
+	FUZZ_INCREMENT,
+	FUZZ_DECREMENT,
+	FUZZ_TO_LONG_LONG,
+	FUZZ_MUL_UI,
+	FUZZ_DIVMOD_UI,
+	FUZZ_DIVMOD_DIVISOR,
+	FUZZ_MULTIPLY,
+	FUZZ_SQUARE,
+	FUZZ_POW_UI,
+	FUZZ_IS_PROBABLE_PRIME,
+	FUZZ_NEXT_PRIME,
+	FUZZ_RANDOM_BELOW,
+	FUZZ_CHECKED,
+	FUZZ_MODULAR,
+	FUZZ_DOUBLE,
+	FUZZ_DECIMAL,
+	FUZZ_BATCH,
+	FUZZ_OPERATIONS_COUNT
+} FuzzOperation;
+
+typedef struct FuzzInput
+{
+	const unsigned char *data;
+	size_t size;
+	size_t position;
+} FuzzInput;
+
+
+/* input decoding, missing bytes read as zeros */
+unsigned char fuzz_byte( FuzzInput *input )
+{
+	if ( input->position >= input->size )
+		return 0;
+	return input->data[input->position++];
+};
+
+unsigned int fuzz_uint( FuzzInput *input )
+{
+	unsigned int value = 0;
+	int i;
+	for ( i = 0; i < 4; ++i )
+		value = (value << 8) | fuzz_byte( input );
+	return value;
+};
+
+/* a big integer with up to maxLength random limbs, in normalized form */
+BigInteger fuzz_big_integer( FuzzInput *input, const int maxLength )
+{
+	BigInteger bigInt = big_integer_create( 0 );
+	unsigned char header = fuzz_byte( input );
+	int length = (header >> 1) % (maxLength + 1);
+	int i;
+
+	for ( i = 0; i < length; ++i )
+		bigInt.data.bits[i] = fuzz_uint( input );
+
+	while ( length > 0 && bigInt.data.bits[length-1] == 0 )
+		--length;
+	if ( length == 0 )
+		return big_integer_create( 0 );
+
+	bigInt.data.length = length;
+	bigInt.sign = ( header & 1 ) ? -1 : 1;
+	return bigInt;
+};
+
+void fuzz_check( const int condition, const char *operation, const char *message )
+{
+	if ( !condition )
+	{
+		fprintf(stderr, "BigInteger fuzz failure in %s: %s\n", operation, message);
+		abort();
+	}
+};
+
+/* the representation invariants every result must keep */
+void fuzz_check_normalized( const BigInteger bigInt, const char *operation )
+{
+	int i;
+	fuzz_check( bigInt.data.length >= 0 && bigInt.data.length <= BIG_INTEGER_DATA_MAX_SIZE, operation, "length out of range" );
+	for ( i = bigInt.data.length; i < BIG_INTEGER_DATA_MAX_SIZE; ++i )
+		fuzz_check( bigInt.data.bits[i] == 0, operation, "limbs above length are not zero" );
+
+	if ( bigInt.sign == 0 )
+	{
+		for ( i = 0; i < bigInt.data.length; ++i )
+			fuzz_check( bigInt.data.bits[i] == 0, operation, "zero sign with a non zero value" );
+	}
+	else
+	{
+		fuzz_check( bigInt.sign == 1 || bigInt.sign == -1, operation, "invalid sign" );
+		fuzz_check( bigInt.data.length > 0 && bigInt.data.bits[bigInt.data.length-1] != 0, operation, "not normalized" );
+	}
+};
+
+void fuzz_check_result( const BigInteger result, const ReferenceInteger *expected, const char *operation )
+{
+	fuzz_check_normalized( result, operation );
+	fuzz_check( reference_equals( expected, result ), operation, "differs from the reference" );
+};
+
+/* the value of a big integer with at most 3 limbs */
+__int128 fuzz_to_int128( const BigInteger bigInt )
+{
+	__int128 value = 0;
+	int i;
+	for ( i = bigInt.data.length - 1; i >= 0; --i )
+		value = (value << 32) | bigInt.data.bits[i];
+	return bigInt.sign < 0 ? -value : value;
+};
+
+void fuzz_check_int128( const BigInteger result, const __int128 expected, const char *operation )
+{
+	fuzz_check( result.data.length <= 3 && fuzz_to_int128( result ) == expected, operation, "differs from __int128" );
+};
+
+int fuzz_sign( const int value )
+{
+	return ( value > 0 ) - ( value < 0 );
+};
+
+void fuzz_binary( const FuzzOperation operation, FuzzInput *input )
+{
+	/* 7 limbs keep every sum within the capacity */
+	BigInteger left = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE - 1 );
+	BigInteger right = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE - 1 );
+	ReferenceInteger refLeft = reference_from_big_integer( left );
+	ReferenceInteger refRight = reference_from_big_integer( right );
+	ReferenceInteger expected;
+	int small = left.data.length <= 2 && right.data.length <= 2;
+
+	switch ( operation )
+	{
+	case FUZZ_ADD:
+		expected = reference_add( &refLeft, &refRight );
+		fuzz_check_result( big_integer_add( left, right ), &expected, "add" );
+		if ( small )
+			fuzz_check_int128( big_integer_add( left, right ), fuzz_to_int128( left ) + fuzz_to_int128( right ), "add" );
+		break;
+
+	case FUZZ_SUBTRACT:
+		expected = reference_subtract( &refLeft, &refRight );
+		fuzz_check_result( big_integer_subtract( left, right ), &expected, "subtract" );
+		if ( small )
+			fuzz_check_int128( big_integer_subtract( left, right ), fuzz_to_int128( left ) - fuzz_to_int128( right ), "subtract" );
+		break;
+
+	case FUZZ_COMPARE:
+		fuzz_check( fuzz_sign( big_integer_compare( left, right ) ) == reference_compare( &refLeft, &refRight ), "compare", "differs from the reference" );
+		fuzz_check( big_integer_compare( left, left ) == 0, "compare", "value differs from itself" );
+		if ( small )
+		{
+			__int128 difference = fuzz_to_int128( left ) - fuzz_to_int128( right );
+			fuzz_check( fuzz_sign( big_integer_compare( left, right ) ) == ( difference > 0 ) - ( difference < 0 ), "compare", "differs from __int128" );
+		}
+		break;
+
+	default:
+		break;
+	}
+};
+
+void fuzz_increment( const FuzzOperation operation, FuzzInput *input )
+{
+	BigInteger bigInt = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE - 1 );
+	unsigned int value = fuzz_uint( input );
+	ReferenceInteger ref = reference_from_big_integer( bigInt );
+	ReferenceInteger refValue = reference_create( value );
+	ReferenceInteger expected;
+	int isSmall = bigInt.data.length <= 2;
+	__int128 small = isSmall ? fuzz_to_int128( bigInt ) : 0;
+
+	if ( operation == FUZZ_INCREMENT )
+	{
+		expected = reference_add( &ref, &refValue );
+		big_integer_increment( &bigInt, value );
+		fuzz_check_result( bigInt, &expected, "increment" );
+		if ( isSmall )
+			fuzz_check_int128( bigInt, small + value, "increment" );
+	}
+	else
+	{
+		expected = reference_subtract( &ref, &refValue );
+		big_integer_decrement( &bigInt, value );
+		fuzz_check_result( bigInt, &expected, "decrement" );
+		if ( isSmall )
+			fuzz_check_int128( bigInt, small - value, "decrement" );
+	}
+};
+
+void fuzz_to_long_long( FuzzInput *input )
+{
+	BigInteger bigInt = fuzz_big_integer( input, 2 );
+	__int128 value = fuzz_to_int128( bigInt );
+
+	/* the conversions abort outside of their range */
+	if ( value >= LLONG_MIN && value <= LLONG_MAX )
+		fuzz_check( big_integer_to_long_long( bigInt ) == (long long) value, "to_long_long", "differs from __int128" );
+	if ( value >= INT_MIN && value <= INT_MAX )
+		fuzz_check( big_integer_to_int( bigInt ) == (int) value, "to_int", "differs from __int128" );
+
+	long long longValue;
+	int intValue;
+	fuzz_check( (big_integer_to_long_long_checked( bigInt, &longValue ) == BIG_INTEGER_OK) == (value >= LLONG_MIN && value <= LLONG_MAX),
+		"to_long_long_checked", "wrong status" );
+	fuzz_check( (big_integer_to_int_checked( bigInt, &intValue ) == BIG_INTEGER_OK) == (value >= INT_MIN && value <= INT_MAX),
+		"to_int_checked", "wrong status" );
+
+	fuzz_check_normalized( big_integer_create( (long long) value ), "create" );
+	if ( value >= LLONG_MIN && value <= LLONG_MAX )
+		fuzz_check( big_integer_compare( big_integer_create( (long long) value ), bigInt ) == 0, "create", "differs from the limbs" );
+};
+
+void fuzz_word_division( const FuzzOperation operation, FuzzInput *input )
+{
+	BigInteger bigInt = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE );
+	unsigned int divisor = fuzz_uint( input );
+	ReferenceInteger ref = reference_from_big_integer( bigInt );
+	ReferenceInteger expected;
+	unsigned int expectedRemainder;
+	unsigned int remainder;
+	unsigned int expectedMod;
+
+	if ( divisor == 0 )
+		divisor = 1;
+
+	expected = reference_divmod_ui( &ref, divisor, &expectedRemainder );
+	expectedMod = ( bigInt.sign < 0 && expectedRemainder > 0 ) ? divisor - expectedRemainder : expectedRemainder;
+
+	if ( operation == FUZZ_DIVMOD_UI )
+	{
+		fuzz_check_result( big_integer_divmod_ui( bigInt, divisor, &remainder ), &expected, "divmod_ui" );
+		fuzz_check( remainder == expectedRemainder, "divmod_ui", "wrong remainder" );
+		fuzz_check( big_integer_mod_ui( bigInt, divisor ) == expectedMod, "mod_ui", "differs from the reference" );
+	}
+	else
+	{
+		BigIntegerDivisor precomputed = big_integer_create_divisor( divisor );
+		fuzz_check_result( big_integer_divmod_divisor( bigInt, &precomputed, &remainder ), &expected, "divmod_divisor" );
+		fuzz_check( remainder == expectedRemainder, "divmod_divisor", "wrong remainder" );
+		fuzz_check( big_integer_mod_divisor( bigInt, &precomputed ) == expectedMod, "mod_divisor", "differs from the reference" );
+	}
+};
+
+void fuzz_multiplication( const FuzzOperation operation, FuzzInput *input )
+{
+	ReferenceInteger expected;
+
+	if ( operation == FUZZ_MUL_UI )
+	{
+		BigInteger bigInt = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE - 1 );
+		unsigned int value = fuzz_uint( input );
+		ReferenceInteger ref = reference_from_big_integer( bigInt );
+		ReferenceInteger refValue = reference_create( value );
+		expected = reference_multiply( &ref, &refValue );
+		fuzz_check_result( big_integer_mul_ui( bigInt, value ), &expected, "mul_ui" );
+		if ( bigInt.data.length <= 2 )
+			fuzz_check_int128( big_integer_mul_ui( bigInt, value ), fuzz_to_int128( bigInt ) * value, "mul_ui" );
+	}
+	else if ( operation == FUZZ_MULTIPLY )
+	{
+		/* the lengths of the operands add up to the capacity at most */
+		BigInteger left = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE / 2 );
+		BigInteger right = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE - MAX( left.data.length, 1 ) );
+		ReferenceInteger refLeft = reference_from_big_integer( left );
+		ReferenceInteger refRight = reference_from_big_integer( right );
+		expected = reference_multiply( &refLeft, &refRight );
+		fuzz_check_result( big_integer_multiply( left, right ), &expected, "multiply" );
+		fuzz_check_result( big_integer_multiply( right, left ), &expected, "multiply" );
+		if ( left.data.length <= 1 && right.data.length <= 1 )
+			fuzz_check_int128( big_integer_multiply( left, right ), fuzz_to_int128( left ) * fuzz_to_int128( right ), "multiply" );
+	}
+	else
+	{
+		BigInteger bigInt = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE / 2 );
+		ReferenceInteger ref = reference_from_big_integer( bigInt );
+		expected = reference_multiply( &ref, &ref );
+		fuzz_check_result( big_integer_square( bigInt ), &expected, "square" );
+		fuzz_check_result( big_integer_multiply( bigInt, bigInt ), &expected, "square" );
+	}
+};
+
+void fuzz_pow_ui( FuzzInput *input )
+{
+	BigInteger base = fuzz_big_integer( input, 2 );
+	unsigned int exponent = fuzz_byte( input );
+	ReferenceInteger ref = reference_from_big_integer( base );
+	ReferenceInteger expected;
+	__int128 magnitude = fuzz_to_int128( base );
+	int numBits = 0;
+
+	/* bases of n bits keep n * exponent bits in the capacity */
+	if ( magnitude < 0 )
+		magnitude = -magnitude;
+	while ( (magnitude >> numBits) != 0 )
+		++numBits;
+	if ( numBits > 1 && exponent > (unsigned int) (255 / numBits) )
+		exponent = 255 / numBits;
+
+	expected = reference_pow_ui( &ref, exponent );
+	fuzz_check_result( big_integer_pow_ui( base, exponent ), &expected, "pow_ui" );
+};
+
+void fuzz_primes( const FuzzOperation operation, FuzzInput *input )
+{
+	BigInteger bigInt = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE - 1 );
+	unsigned char rounds = fuzz_byte( input ) % 16;
+	int isSmall = bigInt.data.length <= 1 || bigInt.sign < 0;
+
+	if ( operation == FUZZ_IS_PROBABLE_PRIME )
+	{
+		int bpsw = big_integer_is_probable_prime( bigInt, 0 );
+		int millerRabin = big_integer_is_probable_prime( bigInt, 20 );
+
+		if ( isSmall )
+			fuzz_check( bpsw == ( bigInt.sign > 0 && reference_is_prime( bigInt.data.bits[0] ) ) && bpsw == big_integer_is_probable_prime( bigInt, rounds ),
+				"is_probable_prime", "differs from trial division" );
+		else
+			fuzz_check( bpsw == millerRabin, "is_probable_prime", "BPSW and Miller-Rabin disagree" );
+
+		/* products of two factors above one are composite */
+		if ( bigInt.data.length <= BIG_INTEGER_DATA_MAX_SIZE / 2 && big_integer_compare( bigInt, big_integer_create( 1 ) ) > 0 )
+		{
+			BigInteger factor = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE / 2 );
+			factor.sign = factor.sign != 0;
+			if ( big_integer_compare( factor, big_integer_create( 1 ) ) > 0 )
+				fuzz_check( big_integer_is_probable_prime( big_integer_multiply( bigInt, factor ), rounds ) == 0,
+					"is_probable_prime", "a product is prime" );
+		}
+	}
+	else
+	{
+		BigInteger next = big_integer_next_prime( bigInt );
+		fuzz_check_normalized( next, "next_prime" );
+		fuzz_check( big_integer_compare( next, bigInt ) > 0, "next_prime", "not above the argument" );
+
+		if ( isSmall )
+		{
+			unsigned long long expected = bigInt.sign > 0 ? bigInt.data.bits[0] + 1ULL : 2;
+			while ( !reference_is_prime( expected ) )
+				++expected;
+			fuzz_check( big_integer_compare( next, big_integer_create( (long long) expected ) ) == 0, "next_prime", "differs from trial division" );
+		}
+		else
+		{
+			/* nothing in between is prime */
+			BigInteger between = bigInt;
+			fuzz_check( big_integer_is_probable_prime( next, 20 ), "next_prime", "not prime" );
+			for ( big_integer_increment( &between, 1 ); big_integer_compare( between, next ) < 0; big_integer_increment( &between, 1 ) )
+				fuzz_check( !big_integer_is_probable_prime( between, 0 ), "next_prime", "skipped a prime" );
+		}
+	}
+};
+
+void fuzz_random_below( FuzzInput *input )
+{
+	BigIntegerRandomState state;
+	BigInteger limit = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE );
+	int i;
+
+	limit.sign = limit.sign != 0;
+	if ( limit.sign == 0 )
+		return;
+
+	big_integer_random_seed( &state, fuzz_uint( input ) );
+	for ( i = 0; i < 4; ++i )
+	{
+		BigInteger value = big_integer_random_below_r( &state, limit );
+		fuzz_check_normalized( value, "random_below" );
+		fuzz_check( value.sign >= 0 && big_integer_compare( value, limit ) < 0, "random_below", "out of range" );
+	}
+};
+
+/* the result must be right when it fits, and left alone with an overflow status when it doesn't */
+void fuzz_check_status( const BigIntegerStatus status, const BigInteger result, const ReferenceInteger *expected, const char *operation )
+{
+	if ( expected->length <= BIG_INTEGER_DATA_MAX_SIZE * 4 )
+	{
+		fuzz_check( status == BIG_INTEGER_OK, operation, "failed with a result that fits" );
+		fuzz_check_result( result, expected, operation );
+	}
+	else
+	{
+		fuzz_check( status == BIG_INTEGER_OVERFLOW, operation, "didn't report the overflow" );
+		fuzz_check( big_integer_compare( result, big_integer_create( 7 ) ) == 0, operation, "changed the result" );
+	}
+	fuzz_check( big_integer_last_error( ) == BIG_INTEGER_OK, operation, "changed the thread's error" );
+};
+
+void fuzz_checked( FuzzInput *input )
+{
+	/* full width operands, so the results may overflow */
+	BigInteger left = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE );
+	BigInteger right = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE );
+	unsigned int value = fuzz_uint( input );
+	ReferenceInteger refLeft = reference_from_big_integer( left );
+	ReferenceInteger refRight = reference_from_big_integer( right );
+	ReferenceInteger refValue = reference_create( value );
+	ReferenceInteger expected;
+	BigInteger result;
+
+	result = big_integer_create( 7 );
+	expected = reference_add( &refLeft, &refRight );
+	fuzz_check_status( big_integer_add_checked( left, right, &result ), result, &expected, "add_checked" );
+
+	result = big_integer_create( 7 );
+	expected = reference_subtract( &refLeft, &refRight );
+	fuzz_check_status( big_integer_subtract_checked( left, right, &result ), result, &expected, "subtract_checked" );
+
+	result = big_integer_create( 7 );
+	expected = reference_multiply( &refLeft, &refRight );
+	fuzz_check_status( big_integer_multiply_checked( left, right, &result ), result, &expected, "multiply_checked" );
+
+	result = big_integer_create( 7 );
+	expected = reference_multiply( &refLeft, &refValue );
+	fuzz_check_status( big_integer_mul_ui_checked( left, value, &result ), result, &expected, "mul_ui_checked" );
+
+	result = left;
+	expected = reference_add( &refLeft, &refValue );
+	BigIntegerStatus status = big_integer_increment_checked( &result, value );
+	if ( status != BIG_INTEGER_OK )
+	{
+		fuzz_check( big_integer_compare( result, left ) == 0, "increment_checked", "changed the value" );
+		result = big_integer_create( 7 );
+	}
+	fuzz_check_status( status, result, &expected, "increment_checked" );
+};
+
+/* there is no reference division by a big modulus, so the results are checked against
+   the definitions: reduce( quotient * modulus + r ) = r and value * value^-1 = 1 */
+void fuzz_modular( FuzzInput *input )
+{
+	BigIntegerRandomState state;
+	BigIntegerModContext context;
+	BigInteger values[4];
+	BigInteger inverses[4];
+	BigInteger one = big_integer_create( 1 );
+	int invertible = 1;
+	int i;
+
+	BigInteger modulus = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE - 1 );
+	modulus.sign = modulus.sign != 0;
+	modulus.data.bits[0] |= 1;
+	if ( modulus.sign == 0 || big_integer_compare( modulus, one ) == 0 )
+		return;
+
+	context = big_integer_create_mod_context( modulus );
+	BigInteger quotient = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE - modulus.data.length );
+	big_integer_random_seed( &state, fuzz_uint( input ) );
+	BigInteger left = big_integer_random_below_r( &state, modulus );
+	BigInteger right = big_integer_random_below_r( &state, modulus );
+	ReferenceInteger refModulus = reference_from_big_integer( modulus );
+	ReferenceInteger refLeft = reference_from_big_integer( left );
+	ReferenceInteger refRight = reference_from_big_integer( right );
+	ReferenceInteger expected;
+
+	BigInteger result = big_integer_mod_reduce( &context, big_integer_add( big_integer_multiply( quotient, modulus ), left ) );
+	fuzz_check_normalized( result, "mod_reduce" );
+	fuzz_check( big_integer_compare( result, left ) == 0, "mod_reduce", "wrong remainder" );
+
+	expected = reference_add( &refLeft, &refRight );
+	if ( reference_compare( &expected, &refModulus ) >= 0 )
+		expected = reference_subtract( &expected, &refModulus );
+	fuzz_check_result( big_integer_mod_add( &context, left, right ), &expected, "mod_add" );
+
+	expected = reference_subtract( &refLeft, &refRight );
+	if ( expected.sign < 0 )
+		expected = reference_add( &expected, &refModulus );
+	fuzz_check_result( big_integer_mod_subtract( &context, left, right ), &expected, "mod_subtract" );
+
+	result = big_integer_mod_multiply( &context, left, right );
+	fuzz_check_normalized( result, "mod_multiply" );
+	fuzz_check( result.sign >= 0 && big_integer_compare( result, modulus ) < 0, "mod_multiply", "out of range" );
+	if ( left.data.length + right.data.length <= BIG_INTEGER_DATA_MAX_SIZE )
+		fuzz_check( big_integer_compare( result, big_integer_mod_reduce( &context, big_integer_multiply( left, right ) ) ) == 0,
+			"mod_multiply", "differs from the reduced product" );
+	fuzz_check( big_integer_compare( big_integer_mod_square( &context, left ), big_integer_mod_multiply( &context, left, left ) ) == 0,
+		"mod_square", "differs from mod_multiply" );
+
+	/* the batch must match one inversion at a time, and fail as a whole */
+	for ( i = 0; i < 4; ++i )
+	{
+		values[i] = ( i == 0 ) ? left : big_integer_random_below_r( &state, modulus );
+		BigIntegerStatus status = big_integer_mod_inverse_checked( &context, values[i], &result );
+		if ( status == BIG_INTEGER_OK )
+			fuzz_check( big_integer_compare( big_integer_mod_multiply( &context, values[i], result ), one ) == 0, "mod_inverse", "wrong inverse" );
+		else
+		{
+			fuzz_check( status == BIG_INTEGER_NOT_INVERTIBLE, "mod_inverse", "unexpected status" );
+			fuzz_check( big_integer_compare( values[i], one ) != 0, "mod_inverse", "one isn't invertible" );
+			invertible = 0;
+		}
+	}
+
+	big_integer_set_error_mode( BIG_INTEGER_ERROR_FLAG );
+	big_integer_batch_invert( &context, values, inverses, 4 );
+	fuzz_check( big_integer_last_error( ) == ( invertible ? BIG_INTEGER_OK : BIG_INTEGER_NOT_INVERTIBLE ), "batch_invert", "wrong status" );
+	big_integer_clear_error( );
+	big_integer_set_error_mode( BIG_INTEGER_ERROR_ABORT );
+
+	for ( i = 0; i < 4; ++i )
+		fuzz_check( big_integer_compare( inverses[i], invertible ? big_integer_mod_inverse( &context, values[i] ) : big_integer_create( 0 ) ) == 0,
+			"batch_invert", "differs from mod_inverse" );
+};
+
+/* value * 2^exponent, exact while it stays in range */
+long double fuzz_scale( long double value, int exponent )
+{
+	for ( ; exponent > 0; --exponent )
+		value *= 2;
+	for ( ; exponent < 0; ++exponent )
+		value /= 2;
+	return value;
+};
+
+void fuzz_check_frexp( const BigInteger bigInt, const long double mantissa, const int exponent, const long double value, const char *operation )
+{
+	if ( bigInt.sign == 0 )
+	{
+		fuzz_check( mantissa == 0 && exponent == 0, operation, "zero isn't 0 * 2^0" );
+		return;
+	}
+
+	long double magnitude = mantissa < 0 ? -mantissa : mantissa;
+	fuzz_check( magnitude >= 0.5L && magnitude < 1, operation, "mantissa out of range" );
+	fuzz_check( fuzz_scale( mantissa, exponent ) == value, operation, "differs from the conversion" );
+};
+
+void fuzz_double( FuzzInput *input )
+{
+	BigInteger bigInt = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE );
+	int i;
+
+	/* low zero limbs make exact values and ties common */
+	int clear = fuzz_byte( input ) % (bigInt.data.length + 1);
+	for ( i = 0; i < clear && i < bigInt.data.length - 1; ++i )
+		bigInt.data.bits[i] = 0;
+
+	ReferenceInteger ref = reference_from_big_integer( bigInt );
+	BigInteger result;
+	long double mantissa;
+	int exponent;
+
+	/* to nearest, ties to even */
+	double value = big_integer_to_double( bigInt );
+	fuzz_check( value == (double) reference_to_floating( &ref, DBL_MANT_DIG ), "to_double", "differs from the reference" );
+	if ( bigInt.data.length <= 3 )
+		fuzz_check( value == (double) fuzz_to_int128( bigInt ), "to_double", "differs from __int128" );
+	mantissa = big_integer_frexp( bigInt, &exponent );
+	fuzz_check_frexp( bigInt, mantissa, exponent, value, "frexp" );
+
+	long double longValue = big_integer_to_long_double( bigInt );
+#if LDBL_MANT_DIG <= 64
+	fuzz_check( longValue == reference_to_floating( &ref, LDBL_MANT_DIG ), "to_long_double", "differs from the reference" );
+#endif
+	if ( bigInt.data.length <= 3 )
+		fuzz_check( longValue == (long double) fuzz_to_int128( bigInt ), "to_long_double", "differs from __int128" );
+	mantissa = big_integer_frexp_long_double( bigInt, &exponent );
+	fuzz_check_frexp( bigInt, mantissa, exponent, longValue, "frexp_long_double" );
+
+	/* values with few enough bits come back unchanged */
+	if ( big_integer_compare( bigInt, big_integer_create( 0 ) ) == 0 || ref.length <= 6 )
+		fuzz_check( big_integer_compare( big_integer_from_double( value ), bigInt ) == 0, "from_double", "round trip changed the value" );
+
+	/* any double, decoded by hand: m * 2^e with a 53 bit m */
+	unsigned long long bits = ((unsigned long long) fuzz_uint( input ) << 32) | fuzz_uint( input );
+	memcpy( &value, &bits, sizeof(value) );
+	int biased = (int) ((bits >> 52) & 0x7FF);
+	unsigned long long significand = (bits & ((1ULL << 52) - 1)) | ( biased != 0 ? 1ULL << 52 : 0 );
+	int e = ( biased != 0 ? biased : 1 ) - 1075;
+	int numBits = 0;
+	while ( numBits < 64 && (significand >> numBits) != 0 )
+		++numBits;
+
+	result = big_integer_create( 7 );
+	BigIntegerStatus status = big_integer_from_double_checked( value, &result );
+	if ( biased == 0x7FF )
+		fuzz_check( status == BIG_INTEGER_INVALID_ARGUMENT, "from_double_checked", "accepted NaN or infinity" );
+	else if ( numBits + e > BIG_INTEGER_DATA_MAX_SIZE * 32 )
+		fuzz_check( status == BIG_INTEGER_OVERFLOW, "from_double_checked", "didn't report the overflow" );
+	else
+	{
+		ReferenceInteger two = reference_create( 2 );
+		ReferenceInteger expected = reference_create( e >= 0 ? significand : ( -e < 64 ? significand >> -e : 0 ) );
+		if ( e > 0 )
+		{
+			ReferenceInteger power = reference_pow_ui( &two, (unsigned int) e );
+			expected = reference_multiply( &expected, &power );
+		}
+		if ( (bits >> 63) && expected.sign != 0 )
+			expected.sign = -1;
+
+		fuzz_check( status == BIG_INTEGER_OK, "from_double_checked", "failed with a value that fits" );
+		fuzz_check_result( result, &expected, "from_double_checked" );
+		fuzz_check_result( big_integer_from_long_double( (long double) value ), &expected, "from_long_double" );
+	}
+	fuzz_check( big_integer_last_error( ) == BIG_INTEGER_OK, "from_double_checked", "changed the thread's error" );
+};
+
+/* collects the output of big_integer_write_decimal_callback, stopping after limit calls */
+typedef struct FuzzDecimal
+{
+	char text[128];
+	int length;
+	int calls;
+	int limit;
+} FuzzDecimal;
+
+int fuzz_decimal_write( const char *digits, const int length, void *context )
+{
+	FuzzDecimal *decimal = (FuzzDecimal *) context;
+	if ( decimal->calls++ == decimal->limit )
+		return 1;
+
+	fuzz_check( length > 0 && decimal->length + length < (int) sizeof(decimal->text), "write_decimal_callback", "bad chunk length" );
+	memcpy( decimal->text + decimal->length, digits, length );
+	decimal->length += length;
+	return 0;
+};
+
+void fuzz_decimal( FuzzInput *input )
+{
+	BigInteger bigInt = fuzz_big_integer( input, BIG_INTEGER_DATA_MAX_SIZE );
+	ReferenceInteger ref = reference_from_big_integer( bigInt );
+	char expected[128];
+	int length = 0;
+	unsigned int digit;
+	int i;
+
+	/* the digits of the reference by repeated division by 10, least significant first */
+	do
+	{
+		ref = reference_divmod_ui( &ref, 10, &digit );
+		expected[length++] = (char) ('0' + digit);
+	} while ( ref.sign != 0 );
+	if ( bigInt.sign < 0 )
+		expected[length++] = '-';
+	for ( i = 0; i < length / 2; ++i )
+	{
+		char swap = expected[i];
+		expected[i] = expected[length - 1 - i];
+		expected[length - 1 - i] = swap;
+	}
+
+	FuzzDecimal decimal;
+	decimal.length = 0;
+	decimal.calls = 0;
+	decimal.limit = -1;
+	fuzz_check( big_integer_write_decimal_callback( bigInt, fuzz_decimal_write, &decimal ) == length,
+		"write_decimal_callback", "wrong number of characters" );
+	fuzz_check( decimal.length == length && memcmp( decimal.text, expected, length ) == 0,
+		"write_decimal_callback", "differs from the reference" );
+
+	/* a callback that stops keeps what was written before */
+	int calls = decimal.calls;
+	decimal.length = 0;
+	decimal.calls = 0;
+	decimal.limit = fuzz_byte( input ) % calls;
+	fuzz_check( big_integer_write_decimal_callback( bigInt, fuzz_decimal_write, &decimal ) == -1,
+		"write_decimal_callback", "didn't stop" );
+	fuzz_check( decimal.calls == decimal.limit + 1 && memcmp( decimal.text, expected, decimal.length ) == 0,
+		"write_decimal_callback", "wrong output before stopping" );
+};
+
+/* the low limbs of a non-negative value, with whether anything above them was dropped */
+BigInteger fuzz_truncate( const BigInteger bigInt, const int length, int *dropped )
+{
+	BigInteger result = big_integer_create( 0 );
+	int i;
+
+	*dropped = 0;
+	for ( i = 0; i < bigInt.data.length; ++i )
+	{
+		if ( i < length )
+			result.data.bits[i] = bigInt.data.bits[i];
+		else if ( bigInt.data.bits[i] != 0 )
+			*dropped = 1;
+	}
+
+	result.data.length = MIN( length, bigInt.data.length );
+	while ( result.data.length > 0 && result.data.bits[result.data.length-1] == 0 )
+		result.data.length--;
+	if ( result.data.length == 0 )
+		return big_integer_create( 0 );
+
+	result.sign = 1;
+	return result;
+};
+
+/* every lane of the batch kernels against the scalar operations */
+void fuzz_batch( FuzzInput *input )
+{
+	BigInteger left[2 * BIG_INTEGER_BATCH_LANES + 1];
+	BigInteger right[2 * BIG_INTEGER_BATCH_LANES + 1];
+	BigInteger values[2 * BIG_INTEGER_BATCH_LANES + 1];
+	unsigned char flags[2 * BIG_INTEGER_BATCH_LANES + 1];
+	signed char comparisons[2 * BIG_INTEGER_BATCH_LANES + 1];
+	int count = 1 + fuzz_byte( input ) % (2 * BIG_INTEGER_BATCH_LANES + 1);
+	int length = 1 + fuzz_byte( input ) % (BIG_INTEGER_DATA_MAX_SIZE - 1);
+	int productLength = 1 + fuzz_byte( input ) % BIG_INTEGER_DATA_MAX_SIZE;
+	BigInteger modulus = big_integer_pow_ui( big_integer_create( 2 ), 32 * length );
+	int dropped;
+	int i;
+
+	/* 7 limbs keep the scalar sums within the capacity */
+	for ( i = 0; i < count; ++i )
+	{
+		left[i] = fuzz_big_integer( input, length );
+		right[i] = fuzz_big_integer( input, length );
+		left[i].sign = left[i].sign != 0;
+		right[i].sign = right[i].sign != 0;
+	}
+
+	BigIntegerBatch leftBatch = big_integer_batch_create( count, length );
+	BigIntegerBatch rightBatch = big_integer_batch_create( count, length );
+	BigIntegerBatch resultBatch = big_integer_batch_create( count, length );
+	big_integer_batch_load( &leftBatch, left );
+	big_integer_batch_load( &rightBatch, right );
+
+	big_integer_batch_add( &resultBatch, &leftBatch, &rightBatch, flags );
+	big_integer_batch_store( &resultBatch, values );
+	for ( i = 0; i < count; ++i )
+	{
+		BigInteger expected = fuzz_truncate( big_integer_add( left[i], right[i] ), length, &dropped );
+		fuzz_check_normalized( values[i], "batch_add" );
+		fuzz_check( big_integer_compare( values[i], expected ) == 0 && flags[i] == dropped, "batch_add", "differs from add" );
+	}
+
+	big_integer_batch_subtract( &resultBatch, &leftBatch, &rightBatch, flags );
+	big_integer_batch_store( &resultBatch, values );
+	for ( i = 0; i < count; ++i )
+	{
+		BigInteger expected = big_integer_subtract( left[i], right[i] );
+		int borrow = expected.sign < 0;
+		if ( borrow )
+			expected = big_integer_add( expected, modulus );
+		fuzz_check_normalized( values[i], "batch_subtract" );
+		fuzz_check( big_integer_compare( values[i], expected ) == 0 && flags[i] == borrow, "batch_subtract", "differs from subtract" );
+	}
+
+	big_integer_batch_compare( &leftBatch, &rightBatch, comparisons );
+	for ( i = 0; i < count; ++i )
+		fuzz_check( comparisons[i] == fuzz_sign( big_integer_compare( left[i], right[i] ) ), "batch_compare", "differs from compare" );
+
+	/* operands of half the capacity, so the scalar product fits */
+	for ( i = 0; i < count; ++i )
+	{
+		left[i] = fuzz_truncate( left[i], BIG_INTEGER_DATA_MAX_SIZE / 2, &dropped );
+		right[i] = fuzz_truncate( right[i], BIG_INTEGER_DATA_MAX_SIZE / 2, &dropped );
+	}
+	big_integer_batch_load( &leftBatch, left );
+	big_integer_batch_load( &rightBatch, right );
+	big_integer_batch_destroy( &resultBatch );
+	resultBatch = big_integer_batch_create( count, productLength );
+	big_integer_batch_multiply( &resultBatch, &leftBatch, &rightBatch, flags );
+	big_integer_batch_store( &resultBatch, values );
+	for ( i = 0; i < count; ++i )
+	{
+		BigInteger expected = fuzz_truncate( big_integer_multiply( left[i], right[i] ), productLength, &dropped );
+		fuzz_check_normalized( values[i], "batch_multiply" );
+		fuzz_check( big_integer_compare( values[i], expected ) == 0 && flags[i] == dropped, "batch_multiply", "differs from multiply" );
+	}
+
+	big_integer_batch_destroy( &leftBatch );
+	big_integer_batch_destroy( &rightBatch );
+	big_integer_batch_destroy( &resultBatch );
+};
+
+int LLVMFuzzerTestOneInput( const unsigned char *data, size_t size )
+{
+	FuzzInput input;
+	input.data = data;
+	input.size = size;
+	input.position = 0;
+
+	FuzzOperation operation = (FuzzOperation) (fuzz_byte( &input ) % FUZZ_OPERATIONS_COUNT);
+	switch ( operation )
+	{
+	case FUZZ_ADD:
+	case FUZZ_SUBTRACT:
+	case FUZZ_COMPARE:
+		fuzz_binary( operation, &input );
+		break;
+	case FUZZ_INCREMENT:
+	case FUZZ_DECREMENT:
+		fuzz_increment( operation, &input );
+		break;
+	case FUZZ_TO_LONG_LONG:
+		fuzz_to_long_long( &input );
+		break;
+	case FUZZ_DIVMOD_UI:
+	case FUZZ_DIVMOD_DIVISOR:
+		fuzz_word_division( operation, &input );
+		break;
+	case FUZZ_MUL_UI:
+	case FUZZ_MULTIPLY:
+	case FUZZ_SQUARE:
+		fuzz_multiplication( operation, &input );
+		break;
+	case FUZZ_POW_UI:
+		fuzz_pow_ui( &input );
+		break;
+	case FUZZ_IS_PROBABLE_PRIME:
+	case FUZZ_NEXT_PRIME:
+		fuzz_primes( operation, &input );
+		break;
+	case FUZZ_RANDOM_BELOW:
+		fuzz_random_below( &input );
+		break;
+	case FUZZ_CHECKED:
+		fuzz_checked( &input );
+		break;
+	case FUZZ_MODULAR:
+		fuzz_modular( &input );
+		break;
+	case FUZZ_DOUBLE:
+		fuzz_double( &input );
+		break;
+	case FUZZ_DECIMAL:
+		fuzz_decimal( &input );
+		break;
+	case FUZZ_BATCH:
+		fuzz_batch( &input );
+		break;
+	default:
+		break;
+	}
+
+	return 0;
+};
+
+#ifndef BIG_INTEGER_LIBFUZZER
+/* AFL and corpus replay read inputs from files (or stdin), -random generates them */
+int main( int argc, char **argv )
+{
+	static unsigned char buffer[FUZZ_MAX_INPUT_SIZE];
+	size_t size;
+	int i;
+
+	if ( argc >= 3 && strcmp( argv[1], "-random" ) == 0 )
+	{
+		BigIntegerRandomState state;
+		long iterations = atol( argv[2] );
+		long n;
+
+		big_integer_random_seed( &state, argc >= 4 ? strtoul( argv[3], NULL, 10 ) : 0 );
+		for ( n = 0; n < iterations; ++n )
+		{
+			size = big_integer_random_next( &state ) % 80;
+			for ( i = 0; i < (int) size; ++i )
+				buffer[i] = (unsigned char) big_integer_random_next( &state );
+			LLVMFuzzerTestOneInput( buffer, size );
+		}
+		printf("%ld random inputs passed.\n", iterations);
+		return EXIT_SUCCESS;
+	}
+
+	if ( argc < 2 )
+	{
+		size = fread( buffer, 1, sizeof(buffer), stdin );
+		LLVMFuzzerTestOneInput( buffer, size );
+		return EXIT_SUCCESS;
+	}
+
+	for ( i = 1; i < argc; ++i )
+	{
+		FILE *file = fopen( argv[i], "rb" );
+		if ( !file )
+		{
+			fprintf(stderr, "Can't open %s\n", argv[i]);
+			return EXIT_FAILURE;
+		}
+		size = fread( buffer, 1, sizeof(buffer), file );
+		fclose( file );
+		LLVMFuzzerTestOneInput( buffer, size );
+	}
+
+	return EXIT_SUCCESS;
+};
+#endif
@@ -0,0 +1,280 @@
+/*
+** big_integer_reference.c
+**     Description: Slow, obviously correct integer arithmetic, used as the
+**                  reference the fuzzer checks big_integer.c against
+**/
+
+#include <stdlib.h>
+#include <string.h>
+#include "big_integer_reference.h"
+
+
+/* PRIVATE FUNCTIONS DECLARATIONS */
+ReferenceInteger reference_zero( );
+void reference_normalize( ReferenceInteger *pRef );
+int reference_compare_digits( const ReferenceInteger *pLeft, const ReferenceInteger *pRight );
+ReferenceInteger reference_add_digits( const ReferenceInteger *pLeft, const ReferenceInteger *pRight );
+ReferenceInteger reference_subtract_digits( const ReferenceInteger *pLeft, const ReferenceInteger *pRight );
+
+
+/* PRIVATE FUNCTIONS IMPLEMENTATION */
+ReferenceInteger reference_zero( )
+{
+	ReferenceInteger ref;
+	memset( &ref, 0, sizeof(ref) );
+	return ref;
+};
+
+/* fixes length from the digits, and the sign of zero */
+void reference_normalize( ReferenceInteger *pRef )
+{
+	pRef->length = REFERENCE_MAX_DIGITS;
+	while ( pRef->length > 0 && pRef->digits[pRef->length-1] == 0 )
+		pRef->length--;
+
+	if ( pRef->length == 0 )
+		pRef->sign = 0;
+};
+
+int reference_compare_digits( const ReferenceInteger *pLeft, const ReferenceInteger *pRight )
+{
+	int i;
+	for ( i = REFERENCE_MAX_DIGITS - 1; i >= 0; --i )
+	{
+		if ( pLeft->digits[i] > pRight->digits[i] )
+			return 1;
+		if ( pLeft->digits[i] < pRight->digits[i] )
+			return -1;
+	}
+
+	return 0;
+};
+
+ReferenceInteger reference_add_digits( const ReferenceInteger *pLeft, const ReferenceInteger *pRight )
+{
+	ReferenceInteger result = reference_zero( );
+	int carry = 0;
+	int i;
+	for ( i = 0; i < REFERENCE_MAX_DIGITS; ++i )
+	{
+		int sum = pLeft->digits[i] + pRight->digits[i] + carry;
+		result.digits[i] = (unsigned char) (sum % 256);
+		carry = sum / 256;
+	}
+
+	result.sign = 1;
+	reference_normalize( &result );
+	return result;
+};
+
+/* left >= right */
+ReferenceInteger reference_subtract_digits( const ReferenceInteger *pLeft, const ReferenceInteger *pRight )
+{
+	ReferenceInteger result = reference_zero( );
+	int borrow = 0;
+	int i;
+	for ( i = 0; i < REFERENCE_MAX_DIGITS; ++i )
+	{
+		int difference = pLeft->digits[i] - pRight->digits[i] - borrow;
+		borrow = 0;
+		if ( difference < 0 )
+		{
+			difference += 256;
+			borrow = 1;
+		}
+		result.digits[i] = (unsigned char) difference;
+	}
+
+	result.sign = 1;
+	reference_normalize( &result );
+	return result;
+};
+
+
+/* PUBLIC FUNCTIONS IMPLEMENTATION */
+ReferenceInteger reference_create( unsigned long long value )
+{
+	ReferenceInteger ref = reference_zero( );
+	int i;
+	for ( i = 0; i < 8; ++i )
+	{
+		ref.digits[i] = (unsigned char) (value % 256);
+		value /= 256;
+	}
+
+	ref.sign = 1;
+	reference_normalize( &ref );
+	return ref;
+};
+
+ReferenceInteger reference_from_big_integer( const BigInteger bigInt )
+{
+	ReferenceInteger ref = reference_zero( );
+	int i, j;
+	for ( i = 0; i < bigInt.data.length; ++i )
+	{
+		unsigned int limb = bigInt.data.bits[i];
+		for ( j = 0; j < 4; ++j )
+		{
+			ref.digits[4*i + j] = (unsigned char) (limb % 256);
+			limb /= 256;
+		}
+	}
+
+	ref.sign = bigInt.sign;
+	reference_normalize( &ref );
+	return ref;
+};
+
+int reference_equals( const ReferenceInteger *left, const BigInteger right )
+{
+	ReferenceInteger ref = reference_from_big_integer( right );
+	return left->sign == right.sign && reference_compare( left, &ref ) == 0;
+};
+
+int reference_compare( const ReferenceInteger *left, const ReferenceInteger *right )
+{
+	if ( left->sign != right->sign )
+		return left->sign > right->sign ? 1 : -1;
+
+	return left->sign * reference_compare_digits( left, right );
+};
+
+ReferenceInteger reference_add( const ReferenceInteger *left, const ReferenceInteger *right )
+{
+	ReferenceInteger result;
+
+	if ( left->sign == 0 )
+		return *right;
+	if ( right->sign == 0 )
+		return *left;
+
+	if ( left->sign == right->sign )
+	{
+		result = reference_add_digits( left, right );
+		result.sign = left->sign;
+	}
+	else if ( reference_compare_digits( left, right ) >= 0 )
+	{
+		result = reference_subtract_digits( left, right );
+		result.sign = left->sign;
+	}
+	else
+	{
+		result = reference_subtract_digits( right, left );
+		result.sign = right->sign;
+	}
+
+	reference_normalize( &result );
+	return result;
+};
+
+ReferenceInteger reference_subtract( const ReferenceInteger *left, const ReferenceInteger *right )
+{
+	ReferenceInteger negated = *right;
+	negated.sign = -negated.sign;
+	return reference_add( left, &negated );
+};
+
+ReferenceInteger reference_multiply( const ReferenceInteger *left, const ReferenceInteger *right )
+{
+	ReferenceInteger result = reference_zero( );
+	int i, j;
+	for ( i = 0; i < left->length; ++i )
+	{
+		int carry = 0;
+		for ( j = 0; i + j < REFERENCE_MAX_DIGITS; ++j )
+		{
+			int digit = ( j < right->length ) ? right->digits[j] : 0;
+			int sum = result.digits[i+j] + left->digits[i] * digit + carry;
+			result.digits[i+j] = (unsigned char) (sum % 256);
+			carry = sum / 256;
+		}
+	}
+
+	result.sign = left->sign * right->sign;
+	reference_normalize( &result );
+	return result;
+};
+
+ReferenceInteger reference_divmod_ui( const ReferenceInteger *left, const unsigned int divisor, unsigned int *remainder )
+{
+	ReferenceInteger result = reference_zero( );
+	unsigned long long rem = 0;
+	int i;
+	for ( i = REFERENCE_MAX_DIGITS - 1; i >= 0; --i )
+	{
+		rem = rem * 256 + left->digits[i];
+		result.digits[i] = (unsigned char) (rem / divisor);
+		rem %= divisor;
+	}
+
+	*remainder = (unsigned int) rem;
+	result.sign = left->sign;
+	reference_normalize( &result );
+	return result;
+};
+
+ReferenceInteger reference_pow_ui( const ReferenceInteger *base, const unsigned int exponent )
+{
+	ReferenceInteger result = reference_create( 1 );
+	unsigned int i;
+	for ( i = 0; i < exponent; ++i )
+		result = reference_multiply( &result, base );
+
+	return result;
+};
+
+long double reference_to_floating( const ReferenceInteger *ref, const int precision )
+{
+	int numBits = 8 * ref->length;
+	while ( numBits > 0 && ((ref->digits[(numBits - 1) / 8] >> ((numBits - 1) % 8)) & 1) == 0 )
+		--numBits;
+
+	/* the top precision bits, the bit below them and whether any lower bit is set */
+	int shift = numBits > precision ? numBits - precision : 0;
+	unsigned long long mantissa = 0;
+	int roundBit = 0;
+	int sticky = 0;
+	int i;
+	for ( i = numBits - 1; i >= 0; --i )
+	{
+		int bit = (ref->digits[i / 8] >> (i % 8)) & 1;
+		if ( i >= shift )
+			mantissa = (mantissa << 1) | bit;
+		else if ( i == shift - 1 )
+			roundBit = bit;
+		else
+			sticky |= bit;
+	}
+
+	if ( roundBit && (sticky || (mantissa & 1)) )
+	{
+		mantissa++;
+		/* rounded up to the next power of two */
+		if ( mantissa == 0 || (precision < 64 && (mantissa >> precision) != 0) )
+		{
+			mantissa = ( mantissa == 0 ) ? 1ULL << 63 : mantissa >> 1;
+			shift++;
+		}
+	}
+
+	long double result = (long double) mantissa;
+	for ( i = 0; i < shift; ++i )
+		result *= 2;
+
+	return ref->sign < 0 ? -result : result;
+};
+
+int reference_is_prime( const unsigned long long value )
+{
+	unsigned long long i;
+	if ( value < 2 )
+		return 0;
+
+	for ( i = 2; i * i <= value; ++i )
+		if ( value % i == 0 )
+			return 0;
+
+	return 1;
+};
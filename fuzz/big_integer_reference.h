@@ -0,0 +1,55 @@
+#ifndef BIG_INTEGER_REFERENCE_H
+#define BIG_INTEGER_REFERENCE_H
+
+/*
+** big_integer_reference.h
+**     Description: Slow, obviously correct integer arithmetic, used as the
+**                  reference the fuzzer checks big_integer.c against
+**/
+
+#include "big_integer.h"
+
+/* twice the BigInteger capacity, so products never overflow */
+#define REFERENCE_MAX_DIGITS	(2 * BIG_INTEGER_DATA_MAX_SIZE * 4 + 1)
+
+typedef struct ReferenceInteger
+{
+	int sign;
+	int length;
+	unsigned char digits[REFERENCE_MAX_DIGITS];	/* base 256, least significant first */
+} ReferenceInteger;
+
+/* creates a reference integer from an unsigned value */
+ReferenceInteger reference_create( unsigned long long value );
+
+/* reads the limbs of a big integer */
+ReferenceInteger reference_from_big_integer( const BigInteger bigInt );
+
+/* returns 1 if both hold the same value */
+int reference_equals( const ReferenceInteger *left, const BigInteger right );
+
+/* compare reference integers */
+int reference_compare( const ReferenceInteger *left, const ReferenceInteger *right );
+
+/* left + right */
+ReferenceInteger reference_add( const ReferenceInteger *left, const ReferenceInteger *right );
+
+/* left - right */
+ReferenceInteger reference_subtract( const ReferenceInteger *left, const ReferenceInteger *right );
+
+/* left * right */
+ReferenceInteger reference_multiply( const ReferenceInteger *left, const ReferenceInteger *right );
+
+/* left / divisor truncated towards zero, remainder gets the absolute value of the remainder */
+ReferenceInteger reference_divmod_ui( const ReferenceInteger *left, const unsigned int divisor, unsigned int *remainder );
+
+/* base ^ exponent by repeated multiplication */
+ReferenceInteger reference_pow_ui( const ReferenceInteger *base, const unsigned int exponent );
+
+/* the value rounded to precision ( <= 64 ) bits, to nearest with ties to even, one bit at a time */
+long double reference_to_floating( const ReferenceInteger *ref, const int precision );
+
+/* primality by trial division */
+int reference_is_prime( const unsigned long long value );
+
+#endif /* BIG_INTEGER_REFERENCE_H */
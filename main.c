@@ -1,11 +1,18 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 #include <limits.h>
 #include <math.h>
 #include <time.h>
+#include <pthread.h>
 #include "macros.h"
 #include "big_integer.h"
+#include "big_integer_batch.h"
+#include "big_integer_file.h"
+#include "big_integer_shared.h"
+#include "big_integer_counter.h"
+#include "big_integer_async.h"
 
 void test_create()
 {
@@ -414,6 +421,1353 @@ void test_decrement()
 	bigInt = big_integer_create( -(long long)UINT_MAX + 15 );
 	big_integer_decrement( &bigInt, 15 );
 	assert( big_integer_to_long_long(bigInt) == -(long long)UINT_MAX );
+
+	bigInt = big_integer_pow_ui( big_integer_create( 2 ), 64 );
+	big_integer_increment( &bigInt, 5 );
+	big_integer_decrement( &bigInt, 1 );
+	assert( bigInt.data.length == 3 );
+	assert( big_integer_mod_ui( bigInt, 1000 ) == 620 );
+};
+
+void test_mul_ui()
+{
+	BigInteger bigInt;
+
+	bigInt = big_integer_mul_ui( big_integer_create( 17 ), 3 );
+	assert( big_integer_to_int(bigInt) == 51 );
+
+	bigInt = big_integer_mul_ui( big_integer_create( -17 ), 3 );
+	assert( big_integer_to_int(bigInt) == -51 );
+
+	bigInt = big_integer_mul_ui( big_integer_create( 17 ), 0 );
+	assert( big_integer_compare(bigInt, big_integer_create( 0 )) == 0 );
+
+	bigInt = big_integer_mul_ui( big_integer_create( 0 ), 17 );
+	assert( big_integer_compare(bigInt, big_integer_create( 0 )) == 0 );
+
+	bigInt = big_integer_mul_ui( big_integer_create( UINT_MAX ), UINT_MAX );
+	/* (2^32 - 1)^2 = 2^64 - 2^33 + 1, too big for a long long */
+	assert( bigInt.sign == 1 && bigInt.data.length == 2 && bigInt.data.bits[1] == UINT_MAX - 1 && bigInt.data.bits[0] == 1 );
+	assert( big_integer_compare(bigInt, big_integer_add( big_integer_subtract( big_integer_pow_ui( big_integer_create( 2 ), 64 ), big_integer_pow_ui( big_integer_create( 2 ), 33 ) ), big_integer_create( 1 ) )) == 0 );
+
+	bigInt = big_integer_mul_ui( big_integer_create( -(long long)UINT_MAX - 7 ), 1000 );
+	assert( big_integer_to_long_long(bigInt) == (-(long long)UINT_MAX - 7) * 1000 );
+};
+
+void test_divmod_ui()
+{
+	BigInteger bigInt;
+	unsigned int remainder;
+
+	bigInt = big_integer_divmod_ui( big_integer_create( 17 ), 5, &remainder );
+	assert( big_integer_to_int(bigInt) == 3 );
+	assert( remainder == 2 );
+
+	bigInt = big_integer_divmod_ui( big_integer_create( -17 ), 5, &remainder );
+	assert( big_integer_to_int(bigInt) == -3 );
+	assert( remainder == 2 );
+
+	bigInt = big_integer_divmod_ui( big_integer_create( 3 ), 5, &remainder );
+	assert( big_integer_compare(bigInt, big_integer_create( 0 )) == 0 );
+	assert( remainder == 3 );
+
+	bigInt = big_integer_divmod_ui( big_integer_create( LLONG_MAX ), 10, &remainder );
+	assert( big_integer_to_long_long(bigInt) == LLONG_MAX / 10 );
+	assert( remainder == LLONG_MAX % 10 );
+
+	bigInt = big_integer_divmod_ui( big_integer_create( LLONG_MAX ), UINT_MAX, NULL );
+	assert( big_integer_to_long_long(bigInt) == LLONG_MAX / UINT_MAX );
+
+	/* ( (2^32-1)^3 * 7 + 5 ) / 7 */
+	bigInt = big_integer_mul_ui( big_integer_create( UINT_MAX ), UINT_MAX );
+	bigInt = big_integer_mul_ui( bigInt, UINT_MAX );
+	bigInt = big_integer_mul_ui( bigInt, 7 );
+	big_integer_increment( &bigInt, 5 );
+	bigInt = big_integer_divmod_ui( bigInt, 7, &remainder );
+	assert( remainder == 5 );
+	bigInt = big_integer_divmod_ui( bigInt, UINT_MAX, &remainder );
+	assert( remainder == 0 );
+	/* (2^32 - 1)^2 = 2^64 - 2^33 + 1, too big for a long long */
+	assert( bigInt.sign == 1 && bigInt.data.length == 2 && bigInt.data.bits[1] == UINT_MAX - 1 && bigInt.data.bits[0] == 1 );
+	assert( big_integer_compare(bigInt, big_integer_add( big_integer_subtract( big_integer_pow_ui( big_integer_create( 2 ), 64 ), big_integer_pow_ui( big_integer_create( 2 ), 33 ) ), big_integer_create( 1 ) )) == 0 );
+
+	assert( big_integer_mod_ui( big_integer_create( 17 ), 5 ) == 2 );
+	assert( big_integer_mod_ui( big_integer_create( -17 ), 5 ) == 3 );
+	assert( big_integer_mod_ui( big_integer_create( -15 ), 5 ) == 0 );
+	assert( big_integer_mod_ui( big_integer_create( 0 ), 5 ) == 0 );
+};
+
+void test_divmod_divisor()
+{
+	unsigned int divisors[] = { 1, 2, 3, 7, 10, 1000000000, 65537, 0x7FFFFFFF, 0x80000000, UINT_MAX };
+	long long values[] = { 0, 1, -1, 17, -17, INT_MAX, UINT_MAX, (long long)UINT_MAX * 3 + 1, LLONG_MAX, LLONG_MIN + 1 };
+	int i, j;
+
+	for ( i = 0; i < (int)(sizeof(divisors) / sizeof(divisors[0])); ++i )
+	{
+		BigIntegerDivisor divisor = big_integer_create_divisor( divisors[i] );
+		for ( j = 0; j < (int)(sizeof(values) / sizeof(values[0])); ++j )
+		{
+			BigInteger bigInt = big_integer_create( values[j] );
+			unsigned int expectedRemainder, remainder;
+			BigInteger expected = big_integer_divmod_ui( bigInt, divisors[i], &expectedRemainder );
+			BigInteger result = big_integer_divmod_divisor( bigInt, &divisor, &remainder );
+
+			assert( big_integer_compare(result, expected) == 0 );
+			assert( remainder == expectedRemainder );
+			assert( big_integer_to_long_long(result) == values[j] / (long long)divisors[i] );
+			assert( big_integer_mod_divisor( bigInt, &divisor ) == big_integer_mod_ui( bigInt, divisors[i] ) );
+		}
+	}
+
+	/* multi limb values that use the whole capacity */
+	BigIntegerDivisor divisor = big_integer_create_divisor( 1000000007 );
+	BigInteger bigInt = big_integer_create( 1 );
+	for ( i = 0; i < 8; ++i )
+	{
+		unsigned int expectedRemainder, remainder;
+		BigInteger expected = big_integer_divmod_ui( bigInt, 1000000007, &expectedRemainder );
+		BigInteger result = big_integer_divmod_divisor( bigInt, &divisor, &remainder );
+		assert( big_integer_compare(result, expected) == 0 );
+		assert( remainder == expectedRemainder );
+
+		bigInt = big_integer_mul_ui( bigInt, 1234567891 );
+		big_integer_increment( &bigInt, i );
+	}
+};
+
+void test_multiply()
+{
+	BigInteger left;
+	BigInteger right;
+	BigInteger result;
+
+	left = big_integer_create( 17 );
+	right = big_integer_create( -3 );
+	result = big_integer_multiply( left, right );
+	assert( big_integer_to_int(result) == -51 );
+
+	left = big_integer_create( -17 );
+	right = big_integer_create( 0 );
+	result = big_integer_multiply( left, right );
+	assert( big_integer_compare(result, big_integer_create( 0 )) == 0 );
+
+	left = big_integer_create( -(long long)UINT_MAX );
+	right = big_integer_create( -(long long)UINT_MAX );
+	result = big_integer_multiply( left, right );
+	assert( result.sign == 1 && result.data.length == 2 && result.data.bits[1] == UINT_MAX - 1 && result.data.bits[0] == 1 );
+
+	/* ( 2^31 + 3 ) * ( 2^31 - 5 ) * ( 2^64 + 1 ) */
+	left = big_integer_create( (long long)INT_MAX + 4 );
+	right = big_integer_create( (long long)INT_MAX - 4 );
+	result = big_integer_multiply( left, right );
+	assert( big_integer_to_long_long(result) == ((long long)INT_MAX + 4) * ((long long)INT_MAX - 4) );
+	left = result;
+	right = big_integer_pow_ui( big_integer_create( 2 ), 64 );
+	big_integer_increment( &right, 1 );
+	result = big_integer_multiply( left, right );
+	assert( big_integer_compare(result, big_integer_add( big_integer_multiply( left, big_integer_pow_ui( big_integer_create( 2 ), 64 ) ), left )) == 0 );
+	assert( big_integer_compare(big_integer_multiply( right, left ), result) == 0 );
+};
+
+void test_square()
+{
+	BigInteger bigInt;
+	int i;
+
+	assert( big_integer_to_int(big_integer_square( big_integer_create( -7 ) )) == 49 );
+	assert( big_integer_compare(big_integer_square( big_integer_create( 0 ) ), big_integer_create( 0 )) == 0 );
+
+	bigInt = big_integer_create( -(long long)UINT_MAX );
+	assert( big_integer_compare(big_integer_square( bigInt ), big_integer_multiply( bigInt, bigInt )) == 0 );
+	assert( big_integer_square( bigInt ).data.bits[1] == UINT_MAX - 1 && big_integer_square( bigInt ).data.bits[0] == 1 );
+
+	/* compare against the generic multiplication with up to 4 limbs */
+	bigInt = big_integer_create( UINT_MAX );
+	for ( i = 0; i < 4; ++i )
+	{
+		assert( big_integer_compare(big_integer_square( bigInt ), big_integer_multiply( bigInt, bigInt )) == 0 );
+		bigInt = big_integer_mul_ui( bigInt, 0xFFFF0001u );
+		big_integer_increment( &bigInt, i * 0x10001u );
+	}
+
+	/* ( 2^128 - 1 )^2 uses the whole capacity */
+	bigInt = big_integer_pow_ui( big_integer_create( 2 ), 128 );
+	big_integer_decrement( &bigInt, 1 );
+	assert( big_integer_compare(big_integer_square( bigInt ), big_integer_multiply( bigInt, bigInt )) == 0 );
+};
+
+void test_pow_ui()
+{
+	BigInteger bigInt;
+	BigInteger expected;
+	int i;
+
+	assert( big_integer_to_int(big_integer_pow_ui( big_integer_create( 0 ), 0 )) == 1 );
+	assert( big_integer_to_int(big_integer_pow_ui( big_integer_create( 0 ), 5 )) == 0 );
+	assert( big_integer_to_int(big_integer_pow_ui( big_integer_create( 5 ), 0 )) == 1 );
+	assert( big_integer_to_int(big_integer_pow_ui( big_integer_create( 1 ), UINT_MAX )) == 1 );
+	assert( big_integer_to_int(big_integer_pow_ui( big_integer_create( -1 ), UINT_MAX )) == -1 );
+	assert( big_integer_to_int(big_integer_pow_ui( big_integer_create( -1 ), 1000 )) == 1 );
+	assert( big_integer_to_int(big_integer_pow_ui( big_integer_create( -2 ), 3 )) == -8 );
+	assert( big_integer_to_long_long(big_integer_pow_ui( big_integer_create( 3 ), 39 )) == 4052555153018976267LL );
+	assert( big_integer_to_long_long(big_integer_pow_ui( big_integer_create( -7 ), 21 )) == -558545864083284007LL );
+
+	/* powers of two against repeated doubling */
+	expected = big_integer_create( 1 );
+	for ( i = 0; i < 255; ++i )
+	{
+		assert( big_integer_compare(big_integer_pow_ui( big_integer_create( 2 ), i ), expected) == 0 );
+		expected = big_integer_mul_ui( expected, 2 );
+	}
+	assert( big_integer_compare(big_integer_pow_ui( big_integer_create( 8 ), 85 ), big_integer_pow_ui( big_integer_create( 2 ), 255 )) == 0 );
+	assert( big_integer_compare(big_integer_pow_ui( big_integer_create( -(1LL << 40) ), 3 ), 
+		big_integer_subtract( big_integer_create( 0 ), big_integer_pow_ui( big_integer_create( 2 ), 120 ) )) == 0 );
+
+	/* small and multi limb bases against repeated multiplication */
+	bigInt = big_integer_create( -(long long)UINT_MAX - 2 );
+	expected = big_integer_create( 1 );
+	for ( i = 0; i < 7; ++i )
+	{
+		assert( big_integer_compare(big_integer_pow_ui( bigInt, i ), expected) == 0 );
+		expected = big_integer_multiply( expected, bigInt );
+	}
+
+	bigInt = big_integer_create( 1000000007 );
+	expected = big_integer_create( 1 );
+	for ( i = 0; i < 8; ++i )
+	{
+		assert( big_integer_compare(big_integer_pow_ui( bigInt, i ), expected) == 0 );
+		expected = big_integer_mul_ui( expected, 1000000007 );
+	}
+};
+
+int is_prime_by_trial_division( long long value )
+{
+	long long i;
+	if ( value < 2 )
+		return 0;
+	for ( i = 2; i * i <= value; ++i )
+		if ( value % i == 0 )
+			return 0;
+	return 1;
+};
+
+void test_is_probable_prime()
+{
+	BigInteger bigInt;
+	long long l;
+
+	for ( l = -10; l < 70000; ++l )
+	{
+		bigInt = big_integer_create( l );
+		assert( big_integer_is_probable_prime( bigInt, 0 ) == is_prime_by_trial_division( l ) );
+		assert( big_integer_is_probable_prime( bigInt, 1 ) == is_prime_by_trial_division( l ) );
+	}
+
+	/* crosses 2^32, where the values become two limbs */
+	for ( l = (long long)UINT_MAX - 3000; l < (long long)UINT_MAX + 3000; ++l )
+	{
+		bigInt = big_integer_create( l );
+		assert( big_integer_is_probable_prime( bigInt, 0 ) == is_prime_by_trial_division( l ) );
+	}
+
+	/* composites that fool Miller-Rabin with the first prime bases */
+	assert( big_integer_is_probable_prime( big_integer_create( 2152302898747LL ), 0 ) == 0 );
+	assert( big_integer_is_probable_prime( big_integer_create( 2152302898747LL ), 5 ) == 1 );
+	assert( big_integer_is_probable_prime( big_integer_create( 2152302898747LL ), 6 ) == 0 );
+	assert( big_integer_is_probable_prime( big_integer_create( 3825123056546413051LL ), 0 ) == 0 );
+	assert( big_integer_is_probable_prime( big_integer_create( 3825123056546413051LL ), 11 ) == 1 );
+	assert( big_integer_is_probable_prime( big_integer_create( 3825123056546413051LL ), 12 ) == 0 );
+
+	/* Mersenne primes and their products */
+	BigInteger m61 = big_integer_pow_ui( big_integer_create( 2 ), 61 );
+	BigInteger m89 = big_integer_pow_ui( big_integer_create( 2 ), 89 );
+	BigInteger m127 = big_integer_pow_ui( big_integer_create( 2 ), 127 );
+	big_integer_decrement( &m61, 1 );
+	big_integer_decrement( &m89, 1 );
+	big_integer_decrement( &m127, 1 );
+	assert( big_integer_is_probable_prime( m61, 0 ) == 1 );
+	assert( big_integer_is_probable_prime( m89, 0 ) == 1 );
+	assert( big_integer_is_probable_prime( m127, 20 ) == 1 );
+	assert( big_integer_is_probable_prime( big_integer_multiply( m61, m89 ), 0 ) == 0 );
+	assert( big_integer_is_probable_prime( big_integer_multiply( m89, m127 ), 0 ) == 0 );
+	assert( big_integer_is_probable_prime( big_integer_square( m127 ), 0 ) == 0 );
+	assert( big_integer_is_probable_prime( big_integer_multiply( m127, m127 ), 20 ) == 0 );
+
+	/* the rounds past the 54 small prime bases draw random bases from the thread's state */
+	BigIntegerRandomState saved = *big_integer_random_thread_state( );
+	assert( big_integer_is_probable_prime( m127, 54 ) == 1 );
+	assert( memcmp( &saved, big_integer_random_thread_state( ), sizeof(saved) ) == 0 );
+	assert( big_integer_is_probable_prime( m127, 100 ) == 1 );
+	assert( memcmp( &saved, big_integer_random_thread_state( ), sizeof(saved) ) != 0 );
+	assert( big_integer_is_probable_prime( big_integer_subtract( big_integer_pow_ui( big_integer_create( 2 ), 255 ), big_integer_create( 19 ) ), 200 ) == 1 );
+	assert( big_integer_is_probable_prime( big_integer_multiply( m61, m89 ), 100 ) == 0 );
+
+	/* 2^255 - 19 and 2^256 - 189 */
+	bigInt = big_integer_pow_ui( big_integer_create( 2 ), 255 );
+	big_integer_decrement( &bigInt, 19 );
+	assert( big_integer_is_probable_prime( bigInt, 0 ) == 1 );
+	big_integer_decrement( &bigInt, 2 );
+	assert( big_integer_is_probable_prime( bigInt, 0 ) == 0 );
+	bigInt = big_integer_pow_ui( big_integer_create( 2 ), 255 );
+	big_integer_decrement( &bigInt, 95 );
+	bigInt = big_integer_mul_ui( bigInt, 2 );
+	big_integer_increment( &bigInt, 1 );
+	assert( big_integer_is_probable_prime( bigInt, 0 ) == 1 );
+};
+
+void test_next_prime()
+{
+	BigInteger bigInt;
+	BigInteger expected;
+	long long l;
+
+	assert( big_integer_to_int(big_integer_next_prime( big_integer_create( -5 ) )) == 2 );
+	assert( big_integer_to_int(big_integer_next_prime( big_integer_create( 2 ) )) == 3 );
+	assert( big_integer_to_int(big_integer_next_prime( big_integer_create( 3 ) )) == 5 );
+	assert( big_integer_to_int(big_integer_next_prime( big_integer_create( 65520 ) )) == 65521 );
+	assert( big_integer_to_int(big_integer_next_prime( big_integer_create( 65521 ) )) == 65537 );
+
+	for ( l = (long long)UINT_MAX - 1000; l < (long long)UINT_MAX + 1000; ++l )
+	{
+		long long next = l + 1;
+		while ( !is_prime_by_trial_division( next ) )
+			++next;
+		assert( big_integer_to_long_long(big_integer_next_prime( big_integer_create( l ) )) == next );
+	}
+
+	/* 2^64 + 13, 2^128 + 51 and 2^255 + 95 */
+	bigInt = big_integer_pow_ui( big_integer_create( 2 ), 64 );
+	expected = bigInt;
+	big_integer_increment( &expected, 13 );
+	assert( big_integer_compare(big_integer_next_prime( bigInt ), expected) == 0 );
+
+	bigInt = big_integer_pow_ui( big_integer_create( 2 ), 128 );
+	expected = bigInt;
+	big_integer_increment( &expected, 51 );
+	assert( big_integer_compare(big_integer_next_prime( bigInt ), expected) == 0 );
+
+	bigInt = big_integer_pow_ui( big_integer_create( 2 ), 255 );
+	expected = bigInt;
+	big_integer_increment( &expected, 95 );
+	assert( big_integer_compare(big_integer_next_prime( bigInt ), expected) == 0 );
+};
+
+void test_is_probable_prime_batch()
+{
+	BigInteger candidates[1000];
+	int results[1000];
+	int i;
+
+	for ( i = 0; i < 1000; ++i )
+		candidates[i] = big_integer_create( (long long)UINT_MAX + 2 * i );
+
+	big_integer_is_probable_prime_batch( candidates, results, 1000, 0, 4 );
+	for ( i = 0; i < 1000; ++i )
+		assert( results[i] == is_prime_by_trial_division( (long long)UINT_MAX + 2 * i ) );
+
+	big_integer_is_probable_prime_batch( candidates, results, 3, 20, 8 );
+	for ( i = 0; i < 3; ++i )
+		assert( results[i] == is_prime_by_trial_division( (long long)UINT_MAX + 2 * i ) );
+};
+
+unsigned long long counting_source( void *context )
+{
+	return ++*(unsigned long long *) context;
+};
+
+void test_random()
+{
+	BigIntegerRandomState state;
+	BigIntegerRandomState other;
+	BigInteger bigInt;
+	BigInteger limit;
+	int counts[6] = { 0, 0, 0, 0, 0, 0 };
+	int i;
+
+	/* same seed, same stream. a jump starts another one */
+	big_integer_random_seed( &state, 42 );
+	big_integer_random_seed( &other, 42 );
+	for ( i = 0; i < 100; ++i )
+		assert( big_integer_random_next( &state ) == big_integer_random_next( &other ) );
+	big_integer_random_jump( &other );
+	assert( big_integer_random_next( &state ) != big_integer_random_next( &other ) );
+
+	assert( big_integer_compare(big_integer_random_bits_r( &state, 0 ), big_integer_create( 0 )) == 0 );
+	big_integer_set_error_mode( BIG_INTEGER_ERROR_FLAG );
+	assert( big_integer_random_bits_r( &state, -1 ).sign == 0 );
+	assert( big_integer_last_error( ) == BIG_INTEGER_INVALID_ARGUMENT );
+	big_integer_clear_error( );
+	assert( big_integer_random_bits_r( &state, 32 * BIG_INTEGER_DATA_MAX_SIZE + 1 ).sign == 0 );
+	assert( big_integer_last_error( ) == BIG_INTEGER_OVERFLOW );
+	big_integer_clear_error( );
+	big_integer_set_error_mode( BIG_INTEGER_ERROR_ABORT );
+
+	/* the top bit shows up, nothing above it does */
+	for ( i = 1; i <= 256; i += 17 )
+	{
+		BigInteger half = big_integer_pow_ui( big_integer_create( 2 ), i - 1 );
+		int topBitSeen = 0;
+		int j;
+		for ( j = 0; j < 100; ++j )
+		{
+			bigInt = big_integer_random_bits_r( &state, i );
+			assert( bigInt.sign >= 0 );
+			assert( bigInt.data.length <= (i + 31) / 32 );
+			if ( big_integer_compare(bigInt, half) >= 0 )
+			{
+				topBitSeen = 1;
+				assert( big_integer_compare(big_integer_subtract( bigInt, half ), half) < 0 );
+			}
+		}
+		assert( topBitSeen );
+	}
+
+	limit = big_integer_pow_ui( big_integer_create( 2 ), 200 );
+	big_integer_increment( &limit, 1 );
+	for ( i = 0; i < 1000; ++i )
+	{
+		bigInt = big_integer_random_below_r( &state, limit );
+		assert( bigInt.sign >= 0 );
+		assert( big_integer_compare(bigInt, limit) < 0 );
+	}
+
+	for ( i = 0; i < 60000; ++i )
+		counts[big_integer_to_int(big_integer_random_below( big_integer_create( 6 ) ))]++;
+	for ( i = 0; i < 6; ++i )
+		assert( counts[i] > 9000 && counts[i] < 11000 );
+
+	/* a custom source */
+	unsigned long long counter = 0;
+	big_integer_random_set_source( &state, counting_source, &counter );
+	bigInt = big_integer_random_bits_r( &state, 96 );
+	assert( counter == 2 );
+	limit = big_integer_pow_ui( big_integer_create( 2 ), 65 );
+	big_integer_increment( &limit, 1 );
+	assert( big_integer_compare(bigInt, limit) == 0 );
+
+	assert( big_integer_random_thread_state( ) == big_integer_random_thread_state( ) );
+};
+
+void test_batch()
+{
+	enum { COUNT = 1003 };
+	static BigInteger left[COUNT];
+	static BigInteger right[COUNT];
+	static BigInteger values[COUNT];
+	unsigned char flags[COUNT];
+	signed char results[COUNT];
+	BigIntegerRandomState state;
+	BigIntegerBatch leftBatch;
+	BigIntegerBatch rightBatch;
+	BigIntegerBatch resultBatch;
+	int i;
+
+	big_integer_random_seed( &state, 31 );
+	for ( i = 0; i < COUNT; ++i )
+	{
+		/* equal values, carries and borrows across all the limbs */
+		left[i] = big_integer_random_bits_r( &state, 1 + (int) (big_integer_random_next( &state ) % 127) );
+		right[i] = ( i % 5 == 0 ) ? left[i] : big_integer_random_bits_r( &state, 1 + (int) (big_integer_random_next( &state ) % 127) );
+		if ( i % 7 == 0 )
+			right[i] = big_integer_subtract( big_integer_pow_ui( big_integer_create( 2 ), 128 ), big_integer_create( 1 ) );
+	}
+
+	leftBatch = big_integer_batch_create( COUNT, 4 );
+	rightBatch = big_integer_batch_create( COUNT, 4 );
+	resultBatch = big_integer_batch_create( COUNT, 4 );
+	big_integer_batch_load( &leftBatch, left );
+	big_integer_batch_load( &rightBatch, right );
+
+	big_integer_batch_store( &leftBatch, values );
+	for ( i = 0; i < COUNT; ++i )
+		assert( big_integer_compare(values[i], left[i]) == 0 );
+
+	/* 128 bit sums carry out, the rest is the sum modulo 2^128 */
+	BigInteger modulus = big_integer_pow_ui( big_integer_create( 2 ), 128 );
+	big_integer_batch_add( &resultBatch, &leftBatch, &rightBatch, flags );
+	big_integer_batch_store( &resultBatch, values );
+	for ( i = 0; i < COUNT; ++i )
+	{
+		BigInteger sum = big_integer_add( left[i], right[i] );
+		int carry = big_integer_compare(sum, modulus) >= 0;
+		assert( flags[i] == carry );
+		assert( big_integer_compare(values[i], carry ? big_integer_subtract( sum, modulus ) : sum) == 0 );
+	}
+
+	big_integer_batch_subtract( &resultBatch, &leftBatch, &rightBatch, flags );
+	big_integer_batch_store( &resultBatch, values );
+	for ( i = 0; i < COUNT; ++i )
+	{
+		BigInteger difference = big_integer_subtract( left[i], right[i] );
+		int borrow = difference.sign < 0;
+		assert( flags[i] == borrow );
+		assert( big_integer_compare(values[i], borrow ? big_integer_add( difference, modulus ) : difference) == 0 );
+	}
+
+	big_integer_batch_compare( &leftBatch, &rightBatch, results );
+	for ( i = 0; i < COUNT; ++i )
+		assert( results[i] == big_integer_compare(left[i], right[i]) );
+
+	/* 4 x 4 limbs always fit in 8, in 5 they overflow unless small */
+	big_integer_batch_destroy( &resultBatch );
+	resultBatch = big_integer_batch_create( COUNT, 8 );
+	big_integer_batch_multiply( &resultBatch, &leftBatch, &rightBatch, flags );
+	big_integer_batch_store( &resultBatch, values );
+	for ( i = 0; i < COUNT; ++i )
+	{
+		assert( flags[i] == 0 );
+		assert( big_integer_compare(values[i], big_integer_multiply( left[i], right[i] )) == 0 );
+	}
+
+	big_integer_batch_destroy( &resultBatch );
+	resultBatch = big_integer_batch_create( COUNT, 5 );
+	big_integer_batch_multiply( &resultBatch, &leftBatch, &rightBatch, flags );
+	big_integer_batch_store( &resultBatch, values );
+	modulus = big_integer_pow_ui( big_integer_create( 2 ), 160 );
+	for ( i = 0; i < COUNT; ++i )
+	{
+		BigInteger product = big_integer_multiply( left[i], right[i] );
+		BigInteger high = product;
+		int j;
+		for ( j = 0; j < 10; ++j )
+			high = big_integer_divmod_ui( high, 0x10000, NULL );
+		assert( flags[i] == (high.sign != 0) );
+		assert( big_integer_compare(values[i], big_integer_subtract( product, big_integer_multiply( high, modulus ) )) == 0 );
+	}
+
+	/* negative values are invalid, too long ones overflow, both load as zero in flag mode */
+	big_integer_set_error_mode( BIG_INTEGER_ERROR_FLAG );
+	left[0] = big_integer_create( -5 );
+	big_integer_batch_load( &leftBatch, left );
+	assert( big_integer_last_error( ) == BIG_INTEGER_INVALID_ARGUMENT );
+	big_integer_clear_error( );
+	left[0] = big_integer_pow_ui( big_integer_create( 2 ), 200 );
+	big_integer_batch_load( &leftBatch, left );
+	assert( big_integer_last_error( ) == BIG_INTEGER_OVERFLOW );
+	big_integer_clear_error( );
+	big_integer_set_error_mode( BIG_INTEGER_ERROR_ABORT );
+	big_integer_batch_store( &leftBatch, values );
+	assert( values[0].sign == 0 && big_integer_compare( values[1], left[1] ) == 0 );
+
+	big_integer_batch_destroy( &leftBatch );
+	big_integer_batch_destroy( &rightBatch );
+	big_integer_batch_destroy( &resultBatch );
+};
+
+void test_file()
+{
+	const char *path = "bigint_test.bin";
+	BigIntegerMapping mapping;
+	BigIntegerFileWriter writer;
+	BigIntegerDivisor divisor = big_integer_create_divisor( 1000000007 );
+	BigIntegerDivisor wideDivisor;
+	BigInteger bigInt;
+	unsigned int bits[1000];
+	unsigned long long expected;
+	int i;
+
+	bigInt = big_integer_subtract( big_integer_create( 0 ), big_integer_pow_ui( big_integer_create( 3 ), 150 ) );
+	assert( big_integer_write_file( path, bigInt ) == 0 );
+	assert( big_integer_map_file( path, &mapping ) == 0 );
+	assert( mapping.sign == -1 && mapping.length == (size_t) bigInt.data.length );
+	assert( big_integer_compare(big_integer_mapping_value( &mapping ), bigInt) == 0 );
+	assert( big_integer_mapping_compare( &mapping, bigInt ) == 0 );
+	assert( big_integer_mapping_compare( &mapping, big_integer_create( 0 ) ) < 0 );
+	assert( big_integer_mapping_compare( &mapping, big_integer_mul_ui( bigInt, 2 ) ) > 0 );
+	assert( big_integer_mapping_mod_divisor( &mapping, &divisor ) == big_integer_mod_ui( bigInt, 1000000007 ) );
+	big_integer_unmap_file( &mapping );
+
+	assert( big_integer_write_file( path, big_integer_create( 0 ) ) == 0 );
+	assert( big_integer_map_file( path, &mapping ) == 0 );
+	assert( mapping.sign == 0 && mapping.length == 0 );
+	assert( big_integer_mapping_compare( &mapping, big_integer_create( 0 ) ) == 0 );
+	big_integer_unmap_file( &mapping );
+
+	/* streamed in pieces, longer than a BigInteger, with leading zeros */
+	for ( i = 0; i < 1000; ++i )
+		bits[i] = ( i < 990 ) ? 0x9E3779B9u * (i + 1) : 0;
+	assert( big_integer_file_writer_open( &writer, path, 1 ) == 0 );
+	for ( i = 0; i < 1000; i += 100 )
+		assert( big_integer_file_writer_append( &writer, bits + i, 100 ) == 0 );
+	assert( big_integer_file_writer_close( &writer ) == 0 );
+
+	assert( big_integer_map_file( path, &mapping ) == 0 );
+	assert( mapping.sign == 1 && mapping.length == 990 );
+	assert( big_integer_mapping_compare( &mapping, big_integer_pow_ui( big_integer_create( 2 ), 255 ) ) > 0 );
+	for ( expected = 0, i = 989; i >= 0; --i )
+		expected = ((expected << 32) + bits[i]) % 1000000007;
+	assert( big_integer_mapping_mod_divisor( &mapping, &divisor ) == expected );
+	wideDivisor = big_integer_create_divisor( 4294967291u );
+	for ( expected = 0, i = 989; i >= 0; --i )
+		expected = ((expected << 32) + bits[i]) % 4294967291u;
+	assert( big_integer_mapping_mod_divisor( &mapping, &wideDivisor ) == expected );
+	big_integer_unmap_file( &mapping );
+
+	/* limbs written by a machine with the other byte order */
+	FILE *file = fopen( path, "r+b" );
+	unsigned char order;
+	fseek( file, 7, SEEK_SET );
+	assert( fread( &order, 1, 1, file ) == 1 );
+	order = 3 - order;
+	fseek( file, 7, SEEK_SET );
+	fwrite( &order, 1, 1, file );
+	fclose( file );
+	assert( big_integer_map_file( path, &mapping ) == 0 );
+	assert( big_integer_mapping_limb( &mapping, 0 ) == 0xB979379Eu );
+	big_integer_unmap_file( &mapping );
+
+	/* invalid files */
+	file = fopen( path, "wb" );
+	fwrite( "BIGI", 1, 4, file );
+	fclose( file );
+	assert( big_integer_map_file( path, &mapping ) == -1 );
+	assert( big_integer_map_file( "no/such/file.bin", &mapping ) == -1 );
+
+	/* files that can't be created */
+	assert( big_integer_write_file( "no/such/file.bin", bigInt ) == -1 );
+	assert( big_integer_file_writer_open( &writer, "no/such/file.bin", 1 ) == -1 );
+	assert( big_integer_file_writer_close( &writer ) == -1 );
+	assert( big_integer_file_writer_open( &writer, path, 1 ) == 0 );
+	assert( big_integer_file_writer_close( &writer ) == 0 );
+	assert( big_integer_file_writer_close( &writer ) == -1 );
+
+	remove( path );
+};
+
+typedef struct DecimalBuffer
+{
+	char text[128];
+	int length;
+	int calls;
+	int limit;
+} DecimalBuffer;
+
+int decimal_buffer_write( const char *digits, const int length, void *context )
+{
+	DecimalBuffer *buffer = (DecimalBuffer *) context;
+	if ( buffer->calls++ == buffer->limit )
+		return 1;
+
+	memcpy( buffer->text + buffer->length, digits, length );
+	buffer->length += length;
+	buffer->text[buffer->length] = '\0';
+	return 0;
+};
+
+const char *decimal_string( const BigInteger bigInt, DecimalBuffer *buffer )
+{
+	buffer->length = 0;
+	buffer->calls = 0;
+	buffer->limit = -1;
+	assert( big_integer_write_decimal_callback( bigInt, decimal_buffer_write, buffer ) == buffer->length );
+	return buffer->text;
+};
+
+void test_write_decimal()
+{
+	long long values[] = { 0, 1, -1, 9, 10, 999999999, 1000000000, 1000000001, -1000000000,
+		1000000000000000000LL, 999999999999999999LL, LLONG_MAX, LLONG_MIN, UINT_MAX, -(long long)UINT_MAX - 1 };
+	DecimalBuffer buffer;
+	char expected[32];
+	BigInteger bigInt;
+	int i;
+
+	for ( i = 0; i < (int)(sizeof(values) / sizeof(values[0])); ++i )
+	{
+		sprintf( expected, "%lld", values[i] );
+		assert( strcmp( decimal_string( big_integer_create( values[i] ), &buffer ), expected ) == 0 );
+	}
+
+	bigInt = big_integer_pow_ui( big_integer_create( 2 ), 255 );
+	assert( strcmp( decimal_string( bigInt, &buffer ),
+		"57896044618658097711785492504343953926634992332820282019728792003956564819968" ) == 0 );
+	assert( buffer.calls == 9 );
+
+	bigInt = big_integer_subtract( big_integer_create( 0 ), big_integer_pow_ui( big_integer_create( 3 ), 150 ) );
+	assert( strcmp( decimal_string( bigInt, &buffer ),
+		"-369988485035126972924700782451696644186473100389722973815184405301748249" ) == 0 );
+
+	bigInt = big_integer_pow_ui( big_integer_create( 10 ), 36 );
+	big_integer_increment( &bigInt, 7 );
+	assert( strcmp( decimal_string( bigInt, &buffer ), "1000000000000000000000000000000000007" ) == 0 );
+
+	/* a zero that went through increment has no limbs */
+	bigInt = big_integer_create( -5 );
+	big_integer_increment( &bigInt, 5 );
+	assert( strcmp( decimal_string( bigInt, &buffer ), "0" ) == 0 );
+
+	/* the callback can stop it */
+	buffer.length = 0;
+	buffer.calls = 0;
+	buffer.limit = 2;
+	assert( big_integer_write_decimal_callback( bigInt = big_integer_pow_ui( big_integer_create( 7 ), 60 ), decimal_buffer_write, &buffer ) == -1 );
+	assert( buffer.calls == 3 );
+
+	FILE *file = tmpfile( );
+	assert( big_integer_write_decimal( file, big_integer_create( -1234567890123LL ) ) == 14 );
+	rewind( file );
+	assert( fgets( expected, sizeof(expected), file ) != NULL );
+	assert( strcmp( expected, "-1234567890123" ) == 0 );
+	fclose( file );
+};
+
+void *shared_reader( void *argument )
+{
+	BigIntegerShared *shared = (BigIntegerShared *) argument;
+	unsigned int expected = big_integer_mod_ui( *big_integer_shared_get( shared ), 1000000007 );
+	int i;
+
+	for ( i = 0; i < 10000; ++i )
+	{
+		BigIntegerShared *reference = big_integer_shared_acquire( shared );
+		assert( big_integer_mod_ui( *big_integer_shared_get( reference ), 1000000007 ) == expected );
+		big_integer_shared_release( reference );
+	}
+
+	big_integer_shared_release( shared );
+	return NULL;
+};
+
+void *failing_allocate( size_t size )
+{
+	return NULL;
+};
+
+void test_shared()
+{
+	BigInteger modulus = big_integer_subtract( big_integer_pow_ui( big_integer_create( 2 ), 255 ), big_integer_create( 19 ) );
+	BigIntegerShared *shared = big_integer_shared_create( modulus );
+	BigIntegerShared *other;
+	BigInteger *value;
+	pthread_t threads[8];
+	int i;
+
+	assert( big_integer_shared_references( shared ) == 1 );
+	assert( big_integer_compare( *big_integer_shared_get( shared ), modulus ) == 0 );
+
+	/* many readers of the same value */
+	for ( i = 0; i < 8; ++i )
+		assert( pthread_create( &threads[i], NULL, shared_reader, big_integer_shared_acquire( shared ) ) == 0 );
+	for ( i = 0; i < 8; ++i )
+		pthread_join( threads[i], NULL );
+	assert( big_integer_shared_references( shared ) == 1 );
+
+	/* the only holder modifies in place */
+	value = big_integer_shared_mutate( &shared );
+	assert( value == &shared->value );
+	big_integer_increment( value, 19 );
+	assert( big_integer_compare( *big_integer_shared_get( shared ), big_integer_pow_ui( big_integer_create( 2 ), 255 ) ) == 0 );
+
+	/* a writer with other holders gets its own copy */
+	other = big_integer_shared_acquire( shared );
+	assert( other == shared && big_integer_shared_references( shared ) == 2 );
+	value = big_integer_shared_mutate( &other );
+	assert( other != shared );
+	assert( big_integer_shared_references( shared ) == 1 && big_integer_shared_references( other ) == 1 );
+	big_integer_decrement( value, 19 );
+	assert( big_integer_compare( *big_integer_shared_get( other ), modulus ) == 0 );
+	assert( big_integer_compare( *big_integer_shared_get( shared ), big_integer_pow_ui( big_integer_create( 2 ), 255 ) ) == 0 );
+
+	big_integer_shared_release( other );
+	big_integer_shared_release( shared );
+
+	/* a copy that can't be allocated */
+	shared = big_integer_shared_create( modulus );
+	other = big_integer_shared_acquire( shared );
+	big_integer_set_error_mode( BIG_INTEGER_ERROR_FLAG );
+	big_integer_set_memory_functions( failing_allocate, NULL );
+	assert( big_integer_shared_create( modulus ) == NULL );
+	assert( big_integer_last_error( ) == BIG_INTEGER_OUT_OF_MEMORY );
+	big_integer_clear_error( );
+	assert( big_integer_shared_mutate( &other ) == NULL );
+	assert( big_integer_last_error( ) == BIG_INTEGER_OUT_OF_MEMORY );
+	assert( other == shared && big_integer_shared_references( shared ) == 2 );
+	big_integer_set_memory_functions( NULL, NULL );
+	big_integer_clear_error( );
+	big_integer_set_error_mode( BIG_INTEGER_ERROR_ABORT );
+
+	big_integer_shared_release( other );
+	big_integer_shared_release( shared );
+};
+
+long double power_of_two( int exponent )
+{
+	long double result = 1;
+	while ( exponent-- > 0 )
+		result *= 2;
+	return result;
+};
+
+BigInteger big_integer_power_of_two( const int exponent )
+{
+	return big_integer_pow_ui( big_integer_create( 2 ), exponent );
+};
+
+void test_double_conversion()
+{
+	long long values[] = { 0, 1, -1, 123456789, -987654321012LL, (1LL << 53) - 1, -(1LL << 53) };
+	BigInteger bigInt;
+	double value;
+	int exponent;
+	int i;
+
+	for ( i = 0; i < (int)(sizeof(values) / sizeof(values[0])); ++i )
+	{
+		assert( big_integer_to_double( big_integer_create( values[i] ) ) == (double) values[i] );
+		assert( big_integer_to_long_double( big_integer_create( values[i] ) ) == (long double) values[i] );
+		assert( big_integer_to_long_long( big_integer_from_double( (double) values[i] ) ) == values[i] );
+	}
+	assert( big_integer_to_long_double( big_integer_create( LLONG_MAX ) ) == (long double) LLONG_MAX );
+	assert( big_integer_to_long_double( big_integer_create( LLONG_MIN ) ) == (long double) LLONG_MIN );
+
+	/* ties go to even, anything past the tie rounds up */
+	bigInt = big_integer_power_of_two( 53 );
+	big_integer_increment( &bigInt, 1 );
+	assert( big_integer_to_double( bigInt ) == (double) power_of_two( 53 ) );
+	big_integer_increment( &bigInt, 2 );
+	assert( big_integer_to_double( bigInt ) == (double) power_of_two( 53 ) + 4 );
+	bigInt = big_integer_add( big_integer_power_of_two( 200 ), big_integer_power_of_two( 147 ) );
+	assert( big_integer_to_double( bigInt ) == (double) power_of_two( 200 ) );
+	big_integer_increment( &bigInt, 1 );
+	assert( big_integer_to_double( bigInt ) == (double) (power_of_two( 200 ) + power_of_two( 148 )) );
+	bigInt = big_integer_subtract( big_integer_create( 0 ), bigInt );
+	assert( big_integer_to_double( bigInt ) == -(double) (power_of_two( 200 ) + power_of_two( 148 )) );
+
+	/* 2^256 - 1 carries into the next power of two */
+	bigInt = big_integer_subtract( big_integer_power_of_two( 255 ), big_integer_create( 1 ) );
+	bigInt = big_integer_add( bigInt, big_integer_power_of_two( 255 ) );
+	assert( big_integer_to_double( bigInt ) == (double) power_of_two( 256 ) );
+	assert( big_integer_to_long_double( bigInt ) == power_of_two( 256 ) );
+	value = big_integer_frexp( bigInt, &exponent );
+	assert( value == 0.5 && exponent == 257 );
+
+	value = big_integer_frexp( big_integer_mul_ui( big_integer_power_of_two( 200 ), 3 ), &exponent );
+	assert( value == 0.75 && exponent == 202 );
+	value = big_integer_frexp( big_integer_create( -5 ), &exponent );
+	assert( value == -0.625 && exponent == 3 );
+	value = big_integer_frexp( big_integer_create( 0 ), &exponent );
+	assert( value == 0 && exponent == 0 );
+	assert( big_integer_frexp_long_double( big_integer_create( LLONG_MAX ), &exponent ) * power_of_two( 63 ) == (long double) LLONG_MAX );
+	assert( exponent == 63 );
+
+	/* from double truncates exactly */
+	assert( big_integer_from_double( 0.75 ).sign == 0 );
+	assert( big_integer_from_double( -0.0 ).sign == 0 );
+	assert( big_integer_to_long_long( big_integer_from_double( -123456.789 ) ) == -123456 );
+	assert( big_integer_to_long_long( big_integer_from_double( 4294967296.5 ) ) == 4294967296LL );
+	bigInt = big_integer_from_double( (double) power_of_two( 200 ) );
+	assert( big_integer_compare( bigInt, big_integer_power_of_two( 200 ) ) == 0 );
+	assert( bigInt.data.length == 7 );
+	bigInt = big_integer_from_double( (double) (power_of_two( 53 ) - 1) * (double) power_of_two( 150 ) );
+	assert( big_integer_compare( bigInt, big_integer_subtract( big_integer_power_of_two( 203 ), big_integer_power_of_two( 150 ) ) ) == 0 );
+	bigInt = big_integer_from_long_double( -power_of_two( 255 ) * 1.5L );
+	assert( big_integer_compare( bigInt, big_integer_subtract( big_integer_create( 0 ),
+		big_integer_add( big_integer_power_of_two( 255 ), big_integer_power_of_two( 254 ) ) ) ) == 0 );
+
+	/* round trips */
+	value = 1;
+	for ( i = 0; i < 170; ++i )
+	{
+		value = value * 2.718281828459045 + 0.1;
+		if ( value < 9e18 )
+			assert( big_integer_to_double( big_integer_from_double( value ) ) == (double) (long long) value );
+		else
+			assert( big_integer_to_double( big_integer_from_double( value ) ) == value );
+		assert( big_integer_to_double( big_integer_from_double( -value ) ) == -big_integer_to_double( big_integer_from_double( value ) ) );
+	}
+};
+
+void *error_mode_of_new_thread( void *argument )
+{
+	*(BigIntegerErrorMode *) argument = big_integer_get_error_mode( );
+	return NULL;
+};
+
+void test_error_model()
+{
+	BigInteger max = big_integer_add( big_integer_subtract( big_integer_power_of_two( 255 ), big_integer_create( 1 ) ), big_integer_power_of_two( 255 ) );
+	BigInteger bigInt = big_integer_create( 42 );
+	BigIntegerErrorMode threadMode = BIG_INTEGER_ERROR_FLAG;
+	BigInteger quotient;
+	unsigned int remainder;
+	long long value;
+	double zero = 0;
+	pthread_t thread;
+	int intValue;
+
+	assert( big_integer_get_error_mode( ) == BIG_INTEGER_ERROR_ABORT );
+	assert( big_integer_last_error( ) == BIG_INTEGER_OK );
+
+	/* the checked functions return the status and leave the result alone on failure */
+	assert( big_integer_add_checked( max, big_integer_create( 1 ), &bigInt ) == BIG_INTEGER_OVERFLOW );
+	assert( big_integer_to_int( bigInt ) == 42 );
+	assert( big_integer_add_checked( max, big_integer_create( -1 ), &bigInt ) == BIG_INTEGER_OK );
+	assert( big_integer_compare( bigInt, big_integer_subtract( max, big_integer_create( 1 ) ) ) == 0 );
+	assert( big_integer_subtract_checked( big_integer_create( 0 ), max, &bigInt ) == BIG_INTEGER_OK );
+	assert( big_integer_subtract_checked( bigInt, big_integer_create( 1 ), &bigInt ) == BIG_INTEGER_OVERFLOW );
+	assert( big_integer_increment_checked( &max, 1 ) == BIG_INTEGER_OVERFLOW );
+	assert( max.data.length == BIG_INTEGER_DATA_MAX_SIZE && max.data.bits[BIG_INTEGER_DATA_MAX_SIZE-1] == UINT_MAX );
+	assert( big_integer_decrement_checked( &bigInt, 1 ) == BIG_INTEGER_OVERFLOW );
+	assert( big_integer_multiply_checked( big_integer_power_of_two( 128 ), big_integer_power_of_two( 128 ), &bigInt ) == BIG_INTEGER_OVERFLOW );
+	assert( big_integer_multiply_checked( big_integer_power_of_two( 128 ), big_integer_power_of_two( 127 ), &bigInt ) == BIG_INTEGER_OK );
+	assert( big_integer_compare( bigInt, big_integer_power_of_two( 255 ) ) == 0 );
+	assert( big_integer_mul_ui_checked( max, 2, &bigInt ) == BIG_INTEGER_OVERFLOW );
+	assert( big_integer_pow_ui_checked( big_integer_create( 2 ), 256, &bigInt ) == BIG_INTEGER_OVERFLOW );
+	assert( big_integer_pow_ui_checked( big_integer_create( 3 ), 162, &bigInt ) == BIG_INTEGER_OVERFLOW );
+	assert( big_integer_pow_ui_checked( big_integer_create( 3 ), 161, &bigInt ) == BIG_INTEGER_OK );
+	assert( big_integer_divmod_ui_checked( max, 0, &quotient, &remainder ) == BIG_INTEGER_DIVISION_BY_ZERO );
+	assert( big_integer_divmod_ui_checked( big_integer_create( 100 ), 7, &quotient, &remainder ) == BIG_INTEGER_OK );
+	assert( big_integer_to_int( quotient ) == 14 && remainder == 2 );
+	assert( big_integer_to_int_checked( big_integer_create( (long long) INT_MAX + 1 ), &intValue ) == BIG_INTEGER_OVERFLOW );
+	assert( big_integer_to_int_checked( big_integer_create( INT_MIN ), &intValue ) == BIG_INTEGER_OK && intValue == INT_MIN );
+	assert( big_integer_to_long_long_checked( big_integer_create( LLONG_MIN ), &value ) == BIG_INTEGER_OK && value == LLONG_MIN );
+	assert( big_integer_to_long_long_checked( big_integer_power_of_two( 63 ), &value ) == BIG_INTEGER_OVERFLOW );
+	assert( big_integer_to_long_long_checked( big_integer_power_of_two( 64 ), &value ) == BIG_INTEGER_OVERFLOW );
+	assert( big_integer_from_double_checked( zero / zero, &bigInt ) == BIG_INTEGER_INVALID_ARGUMENT );
+	assert( big_integer_from_double_checked( -1 / zero, &bigInt ) == BIG_INTEGER_INVALID_ARGUMENT );
+	assert( big_integer_from_double_checked( (double) power_of_two( 256 ), &bigInt ) == BIG_INTEGER_OVERFLOW );
+	assert( big_integer_from_double_checked( -1e76, &bigInt ) == BIG_INTEGER_OK && bigInt.sign == -1 );
+
+	/* none of that touched the thread's state */
+	assert( big_integer_get_error_mode( ) == BIG_INTEGER_ERROR_ABORT );
+	assert( big_integer_last_error( ) == BIG_INTEGER_OK );
+
+	/* in flag mode failures return zero and the first error is kept */
+	big_integer_set_error_mode( BIG_INTEGER_ERROR_FLAG );
+	bigInt = big_integer_add( max, big_integer_create( 1 ) );
+	assert( bigInt.sign == 0 && big_integer_compare( bigInt, big_integer_create( 0 ) ) == 0 );
+	assert( big_integer_last_error( ) == BIG_INTEGER_OVERFLOW );
+	assert( big_integer_to_int( big_integer_divmod_ui( max, 0, &remainder ) ) == 0 && remainder == 0 );
+	assert( big_integer_last_error( ) == BIG_INTEGER_OVERFLOW );
+	big_integer_clear_error( );
+
+	assert( big_integer_to_long_long( max ) == 0 );
+	assert( big_integer_last_error( ) == BIG_INTEGER_OVERFLOW );
+	big_integer_clear_error( );
+	bigInt = max;
+	big_integer_increment( &bigInt, 5 );
+	assert( bigInt.sign == 0 && big_integer_last_error( ) == BIG_INTEGER_OVERFLOW );
+	big_integer_clear_error( );
+	assert( big_integer_multiply( max, max ).sign == 0 );
+	assert( big_integer_square( max ).sign == 0 );
+	assert( big_integer_pow_ui( big_integer_create( 10 ), 80 ).sign == 0 );
+	assert( big_integer_last_error( ) == BIG_INTEGER_OVERFLOW );
+	big_integer_clear_error( );
+	assert( big_integer_next_prime( big_integer_subtract( max, big_integer_create( 30 ) ) ).sign == 0 );
+	assert( big_integer_last_error( ) == BIG_INTEGER_OVERFLOW );
+	big_integer_clear_error( );
+	assert( big_integer_create_divisor( 0 ).value == 1 );
+	assert( big_integer_random_below( big_integer_create( -3 ) ).sign == 0 );
+	assert( big_integer_last_error( ) == BIG_INTEGER_DIVISION_BY_ZERO );
+	big_integer_clear_error( );
+	assert( big_integer_last_error( ) == BIG_INTEGER_OK );
+
+	/* the mode belongs to each thread */
+	assert( pthread_create( &thread, NULL, error_mode_of_new_thread, &threadMode ) == 0 );
+	pthread_join( thread, NULL );
+	assert( threadMode == BIG_INTEGER_ERROR_ABORT );
+
+	big_integer_set_error_mode( BIG_INTEGER_ERROR_ABORT );
+	assert( strcmp( big_integer_status_string( BIG_INTEGER_OVERFLOW ), "overflow" ) == 0 );
+	assert( strcmp( big_integer_status_string( BIG_INTEGER_OK ), "no error" ) == 0 );
+};
+
+typedef struct CounterWorker
+{
+	BigIntegerCounter *counter;
+	unsigned long long amount;
+	int count;
+	int done;
+} CounterWorker;
+
+void *counter_writer( void *argument )
+{
+	CounterWorker *worker = (CounterWorker *) argument;
+	int i;
+
+	for ( i = 0; i < worker->count; ++i )
+		big_integer_counter_add( worker->counter, worker->amount + i );
+
+	__atomic_store_n( &worker->done, 1, __ATOMIC_RELEASE );
+	return NULL;
+};
+
+void test_counter()
+{
+	static BigIntegerCounter counter;
+	CounterWorker workers[8];
+	pthread_t threads[8];
+	CounterWorker sharedWorkers[2 * BIG_INTEGER_COUNTER_SHARDS + 2];
+	pthread_t sharedThreads[2 * BIG_INTEGER_COUNTER_SHARDS + 2];
+	BigInteger expected;
+	BigInteger previous;
+	BigInteger total;
+	int running;
+	int i;
+
+	big_integer_counter_init( &counter );
+	assert( big_integer_compare( big_integer_counter_read( &counter ), big_integer_create( 0 ) ) == 0 );
+
+	big_integer_counter_add( &counter, 5 );
+	big_integer_counter_add( &counter, 0 );
+	assert( big_integer_compare( big_integer_counter_read( &counter ), big_integer_create( 5 ) ) == 0 );
+
+	/* crossing 2^63 and amounts above it */
+	big_integer_counter_add( &counter, LLONG_MAX );
+	big_integer_counter_add( &counter, ~0ULL );
+	big_integer_counter_add( &counter, ~0ULL );
+	expected = big_integer_add( big_integer_create( 4 ), big_integer_power_of_two( 63 ) );
+	expected = big_integer_add( expected, big_integer_mul_ui( big_integer_subtract( big_integer_power_of_two( 64 ), big_integer_create( 1 ) ), 2 ) );
+	assert( big_integer_compare( big_integer_counter_read( &counter ), expected ) == 0 );
+
+	/* many writers, while reads never go backwards */
+	big_integer_counter_init( &counter );
+	expected = big_integer_create( 0 );
+	for ( i = 0; i < 8; ++i )
+	{
+		workers[i].counter = &counter;
+		workers[i].amount = (1ULL << 60) + (unsigned long long) i * 1000003;
+		workers[i].count = 20000;
+		workers[i].done = 0;
+		assert( pthread_create( &threads[i], NULL, counter_writer, &workers[i] ) == 0 );
+
+		/* sum of amount + k for k < count */
+		expected = big_integer_add( expected, big_integer_mul_ui( big_integer_power_of_two( 60 ), 20000 ) );
+		expected = big_integer_add( expected, big_integer_create( (long long) i * 1000003 * 20000 ) );
+		expected = big_integer_add( expected, big_integer_create( 19999LL * 20000 / 2 ) );
+	}
+
+	previous = big_integer_create( 0 );
+	do
+	{
+		running = 0;
+		for ( i = 0; i < 8; ++i )
+			running += !__atomic_load_n( &workers[i].done, __ATOMIC_ACQUIRE );
+
+		total = big_integer_counter_read( &counter );
+		assert( big_integer_compare( total, previous ) >= 0 );
+		assert( big_integer_compare( total, expected ) <= 0 );
+		previous = total;
+	} while ( running > 0 );
+
+	for ( i = 0; i < 8; ++i )
+		pthread_join( threads[i], NULL );
+	assert( big_integer_compare( big_integer_counter_read( &counter ), expected ) == 0 );
+
+	/* more threads than shards, adding just below 2^63 to the shards they share */
+	big_integer_counter_init( &counter );
+	expected = big_integer_create( 0 );
+	for ( i = 0; i < 2 * BIG_INTEGER_COUNTER_SHARDS + 2; ++i )
+	{
+		sharedWorkers[i].counter = &counter;
+		sharedWorkers[i].amount = (unsigned long long) LLONG_MAX - 1000;
+		sharedWorkers[i].count = 200;
+		sharedWorkers[i].done = 0;
+		assert( pthread_create( &sharedThreads[i], NULL, counter_writer, &sharedWorkers[i] ) == 0 );
+
+		expected = big_integer_add( expected, big_integer_mul_ui( big_integer_create( LLONG_MAX - 1000 ), 200 ) );
+		expected = big_integer_add( expected, big_integer_create( 199 * 200 / 2 ) );
+	}
+	for ( i = 0; i < 2 * BIG_INTEGER_COUNTER_SHARDS + 2; ++i )
+		pthread_join( sharedThreads[i], NULL );
+	assert( big_integer_compare( big_integer_counter_read( &counter ), expected ) == 0 );
+};
+
+int cancel_after( const double progress, void *context )
+{
+	return --*(int *) context < 0;
+};
+
+typedef struct AsyncBlocker
+{
+	pthread_mutex_t lock;
+	pthread_cond_t changed;
+	int waiting;
+	int released;
+} AsyncBlocker;
+
+/* holds the worker reporting until the blocker is released */
+int hold_worker( const double progress, void *context )
+{
+	AsyncBlocker *blocker = (AsyncBlocker *) context;
+	pthread_mutex_lock( &blocker->lock );
+	blocker->waiting++;
+	pthread_cond_broadcast( &blocker->changed );
+	while ( !blocker->released )
+		pthread_cond_wait( &blocker->changed, &blocker->lock );
+	pthread_mutex_unlock( &blocker->lock );
+	return 0;
+};
+
+void test_async()
+{
+	const int count = 100000;
+	BigInteger *candidates = (BigInteger *) malloc( sizeof(BigInteger) * count );
+	int *results = (int *) malloc( sizeof(int) * count );
+	int *expected = (int *) malloc( sizeof(int) * count );
+	BigIntegerFuture *future;
+	BigIntegerFuture *queued;
+	BigIntegerFuture *other;
+	AsyncBlocker blocker;
+	BigInteger result;
+	double progress;
+	int calls;
+	int primes;
+	int i;
+
+	big_integer_random_seed( big_integer_random_thread_state( ), 38 );
+	for ( i = 0; i < count; ++i )
+		candidates[i] = big_integer_random_bits( 64 + i % 192 );
+
+	/* a progress function cancels next_prime, even in abort mode */
+	calls = 0;
+	big_integer_set_progress( cancel_after, &calls );
+	result = big_integer_next_prime( big_integer_power_of_two( 200 ) );
+	big_integer_set_progress( NULL, NULL );
+	assert( result.sign == 0 && big_integer_last_error( ) == BIG_INTEGER_CANCELLED );
+	big_integer_clear_error( );
+
+	calls = 10;
+	big_integer_set_progress( cancel_after, &calls );
+	big_integer_is_probable_prime_batch( candidates, results, 1000, 0, 4 );
+	big_integer_set_progress( NULL, NULL );
+	assert( big_integer_last_error( ) == BIG_INTEGER_CANCELLED );
+	big_integer_clear_error( );
+
+	assert( big_integer_async_start( 2 ) == 0 );
+
+	future = big_integer_async_multiply( big_integer_power_of_two( 100 ), big_integer_create( -3 ) );
+	assert( big_integer_async_wait( future, &result ) == BIG_INTEGER_OK );
+	assert( big_integer_compare( result, big_integer_mul_ui( big_integer_power_of_two( 100 ), 3 ) ) == -1 );
+	assert( big_integer_async_poll( future ) == BIG_INTEGER_ASYNC_DONE && big_integer_async_progress( future ) == 1 );
+	big_integer_async_release( future );
+
+	future = big_integer_async_pow_ui( big_integer_create( 3 ), 1000 );
+	result = big_integer_create( 5 );
+	assert( big_integer_async_wait( future, &result ) == BIG_INTEGER_OVERFLOW );
+	assert( big_integer_to_int( result ) == 5 );
+	big_integer_async_release( future );
+
+	future = big_integer_async_next_prime( big_integer_power_of_two( 200 ) );
+	assert( big_integer_async_wait( future, &result ) == BIG_INTEGER_OK );
+	assert( big_integer_compare( result, big_integer_next_prime( big_integer_power_of_two( 200 ) ) ) == 0 );
+	big_integer_async_release( future );
+
+	/* polling while the batch runs */
+	big_integer_is_probable_prime_batch( candidates, expected, 20000, 0, 1 );
+	future = big_integer_async_is_probable_prime_batch( candidates, results, 20000, 0, 8 );
+	progress = 0;
+	while ( big_integer_async_poll( future ) != BIG_INTEGER_ASYNC_DONE )
+	{
+		double current = big_integer_async_progress( future );
+		assert( current >= progress && current <= 1 );
+		progress = current;
+	}
+	assert( big_integer_async_wait( future, &result ) == BIG_INTEGER_OK );
+	for ( i = 0, primes = 0; i < 20000; ++i )
+	{
+		assert( results[i] == expected[i] );
+		primes += expected[i];
+	}
+	assert( big_integer_to_int( result ) == primes && primes > 0 );
+	big_integer_async_release( future );
+
+	/* a batch of two shares holds both workers in the progress function, so what comes
+	   next stays queued until it is released */
+	pthread_mutex_init( &blocker.lock, NULL );
+	pthread_cond_init( &blocker.changed, NULL );
+	blocker.waiting = 0;
+	blocker.released = 0;
+	big_integer_set_progress( hold_worker, &blocker );
+	future = big_integer_async_is_probable_prime_batch( candidates, results, count, 0, 2 );
+	big_integer_set_progress( NULL, NULL );
+	pthread_mutex_lock( &blocker.lock );
+	while ( blocker.waiting < 2 )
+		pthread_cond_wait( &blocker.changed, &blocker.lock );
+	pthread_mutex_unlock( &blocker.lock );
+
+	other = big_integer_async_is_probable_prime_batch( candidates, expected, count, 0, 4 );
+	queued = big_integer_async_next_prime( big_integer_create( 1000 ) );
+	assert( big_integer_async_poll( future ) == BIG_INTEGER_ASYNC_RUNNING );
+	assert( big_integer_async_poll( other ) == BIG_INTEGER_ASYNC_PENDING );
+	assert( big_integer_async_poll( queued ) == BIG_INTEGER_ASYNC_PENDING );
+	big_integer_async_cancel( queued );
+	big_integer_async_cancel( other );
+	assert( big_integer_async_poll( queued ) == BIG_INTEGER_ASYNC_DONE );
+	assert( big_integer_async_wait( queued, NULL ) == BIG_INTEGER_CANCELLED );
+	assert( big_integer_async_wait( other, NULL ) == BIG_INTEGER_CANCELLED );
+
+	/* the running batch stops at its next candidate */
+	big_integer_async_cancel( future );
+	pthread_mutex_lock( &blocker.lock );
+	blocker.released = 1;
+	pthread_cond_broadcast( &blocker.changed );
+	pthread_mutex_unlock( &blocker.lock );
+	assert( big_integer_async_wait( future, NULL ) == BIG_INTEGER_CANCELLED );
+	pthread_mutex_destroy( &blocker.lock );
+	pthread_cond_destroy( &blocker.changed );
+	big_integer_async_release( queued );
+	big_integer_async_release( future );
+	big_integer_async_release( other );
+
+	/* a future that can't be allocated */
+	big_integer_set_error_mode( BIG_INTEGER_ERROR_FLAG );
+	big_integer_set_memory_functions( failing_allocate, NULL );
+	assert( big_integer_async_multiply( big_integer_create( 6 ), big_integer_create( 7 ) ) == NULL );
+	assert( big_integer_async_is_probable_prime_batch( candidates, results, count, 0, 2 ) == NULL );
+	big_integer_set_memory_functions( NULL, NULL );
+	assert( big_integer_last_error( ) == BIG_INTEGER_OUT_OF_MEMORY );
+	big_integer_clear_error( );
+	big_integer_set_error_mode( BIG_INTEGER_ERROR_ABORT );
+
+	/* stopping cancels what is queued, the next operation starts the pool again */
+	big_integer_async_stop( );
+	future = big_integer_async_multiply( big_integer_create( 6 ), big_integer_create( 7 ) );
+	assert( big_integer_async_wait( future, &result ) == BIG_INTEGER_OK && big_integer_to_int( result ) == 42 );
+	big_integer_async_release( future );
+	big_integer_async_stop( );
+
+	free( candidates );
+	free( results );
+	free( expected );
+};
+
+void test_mod_context()
+{
+	const int count = 1000;
+	BigInteger values[1000];
+	BigInteger inverses[1000];
+	BigInteger moduli[4];
+	BigInteger a, b, c, result;
+	BigIntegerModContext context;
+	long long x, y;
+	int i, j;
+
+	/* a single limb modulus, checked against long long */
+	context = big_integer_create_mod_context( big_integer_create( 1000003 ) );
+	big_integer_random_seed( big_integer_random_thread_state( ), 39 );
+	for ( i = 0; i < 1000; ++i )
+	{
+		x = (long long) (big_integer_random_next( big_integer_random_thread_state( ) ) % 1000003);
+		y = (long long) (big_integer_random_next( big_integer_random_thread_state( ) ) % 1000003);
+		a = big_integer_create( x );
+		b = big_integer_create( y );
+		assert( big_integer_to_long_long( big_integer_mod_add( &context, a, b ) ) == (x + y) % 1000003 );
+		assert( big_integer_to_long_long( big_integer_mod_subtract( &context, a, b ) ) == (x - y + 1000003) % 1000003 );
+		assert( big_integer_to_long_long( big_integer_mod_multiply( &context, a, b ) ) == x * y % 1000003 );
+		assert( big_integer_to_long_long( big_integer_mod_square( &context, a ) ) == x * x % 1000003 );
+		if ( x != 0 )
+			assert( big_integer_to_long_long( big_integer_mod_inverse( &context, a ) ) * x % 1000003 == 1 );
+	}
+	assert( big_integer_to_int( big_integer_mod_reduce( &context, big_integer_create( -1 ) ) ) == 1000002 );
+	assert( big_integer_to_int( big_integer_mod_reduce( &context, big_integer_create( 5000020 ) ) ) == 5 );
+	assert( big_integer_mod_reduce( &context, big_integer_create( -3000009 ) ).sign == 0 );
+
+	/* 2^255 - 19, and primes of 1, 3 and 8 limbs */
+	moduli[0] = big_integer_subtract( big_integer_power_of_two( 255 ), big_integer_create( 19 ) );
+	moduli[1] = big_integer_create( 4294967291LL );
+	moduli[2] = big_integer_next_prime( big_integer_add( big_integer_random_bits( 95 ), big_integer_power_of_two( 95 ) ) );
+	moduli[3] = big_integer_next_prime( big_integer_add( big_integer_random_bits( 253 ), big_integer_power_of_two( 254 ) ) );
+
+	for ( j = 0; j < 4; ++j )
+	{
+		context = big_integer_create_mod_context( moduli[j] );
+		for ( i = 0; i < 200; ++i )
+		{
+			a = big_integer_random_below( moduli[j] );
+			b = big_integer_random_below( moduli[j] );
+			c = big_integer_random_below( moduli[j] );
+
+			assert( big_integer_compare( big_integer_mod_subtract( &context, big_integer_mod_add( &context, a, b ), b ), a ) == 0 );
+			assert( big_integer_compare( big_integer_mod_multiply( &context, a, big_integer_mod_add( &context, b, c ) ),
+				big_integer_mod_add( &context, big_integer_mod_multiply( &context, a, b ), big_integer_mod_multiply( &context, a, c ) ) ) == 0 );
+			assert( big_integer_compare( big_integer_mod_square( &context, a ), big_integer_mod_multiply( &context, a, a ) ) == 0 );
+			assert( big_integer_compare( big_integer_mod_reduce( &context, a ), a ) == 0 );
+			assert( big_integer_compare( big_integer_mod_reduce( &context, big_integer_add( a, moduli[j] ) ), a ) == 0 );
+			result = big_integer_mod_reduce( &context, big_integer_subtract( a, moduli[j] ) );
+			assert( big_integer_compare( result, a ) == 0 );
+
+			/* small enough operands need no reduction */
+			a = big_integer_random_bits( moduli[j].data.length * 16 - 1 );
+			b = big_integer_random_bits( moduli[j].data.length * 16 - 1 );
+			assert( big_integer_compare( big_integer_mod_multiply( &context, a, b ), big_integer_multiply( a, b ) ) == 0 );
+
+			if ( a.sign != 0 )
+				assert( big_integer_compare( big_integer_mod_multiply( &context, a, big_integer_mod_inverse( &context, a ) ), big_integer_create( 1 ) ) == 0 );
+		}
+
+		/* the reduction of a product too large for the modulus */
+		a = big_integer_random_below( moduli[j] );
+		b = big_integer_random_bits( 250 - moduli[j].data.length * 32 > 0 ? 250 - moduli[j].data.length * 32 : 1 );
+		result = big_integer_mod_reduce( &context, big_integer_add( big_integer_multiply( b, moduli[j] ), a ) );
+		assert( big_integer_compare( result, a ) == 0 );
+	}
+
+	/* batch inversion, against one inversion at a time */
+	context = big_integer_create_mod_context( moduli[0] );
+	for ( i = 0; i < count; ++i )
+		values[i] = big_integer_random_below( moduli[0] );
+	values[0] = big_integer_create( 1 );
+	values[1] = big_integer_subtract( moduli[0], big_integer_create( 1 ) );
+	big_integer_batch_invert( &context, values, inverses, count );
+	for ( i = 0; i < count; ++i )
+		assert( big_integer_compare( inverses[i], big_integer_mod_inverse( &context, values[i] ) ) == 0 );
+	big_integer_batch_invert( &context, values + 5, inverses, 1 );
+	assert( big_integer_compare( inverses[0], big_integer_mod_inverse( &context, values[5] ) ) == 0 );
+
+	/* values that share a factor with the modulus */
+	context = big_integer_create_mod_context( big_integer_create( 15 ) );
+	assert( big_integer_to_int( big_integer_mod_inverse( &context, big_integer_create( 2 ) ) ) == 8 );
+	assert( big_integer_mod_inverse_checked( &context, big_integer_create( 5 ), &result ) == BIG_INTEGER_NOT_INVERTIBLE );
+	assert( big_integer_mod_inverse_checked( &context, big_integer_create( 0 ), &result ) == BIG_INTEGER_NOT_INVERTIBLE );
+	assert( big_integer_mod_inverse_checked( &context, big_integer_create( 7 ), &result ) == BIG_INTEGER_OK );
+	assert( big_integer_to_int( result ) == 13 );
+
+	big_integer_set_error_mode( BIG_INTEGER_ERROR_FLAG );
+	for ( i = 0; i < 4; ++i )
+		values[i] = big_integer_create( i + 1 );
+	values[2] = big_integer_create( 6 );
+	big_integer_batch_invert( &context, values, inverses, 4 );
+	assert( big_integer_last_error( ) == BIG_INTEGER_NOT_INVERTIBLE );
+	for ( i = 0; i < 4; ++i )
+		assert( inverses[i].sign == 0 );
+	big_integer_clear_error( );
+
+	/* values out of [0, modulus) */
+	assert( big_integer_mod_add( &context, big_integer_create( -3 ), big_integer_create( 5 ) ).sign == 0 );
+	assert( big_integer_last_error( ) == BIG_INTEGER_INVALID_ARGUMENT );
+	big_integer_clear_error( );
+	assert( big_integer_mod_multiply( &context, big_integer_create( 2 ), big_integer_add( big_integer_power_of_two( 64 ), big_integer_create( 2 ) ) ).sign == 0 );
+	assert( big_integer_last_error( ) == BIG_INTEGER_INVALID_ARGUMENT );
+	big_integer_clear_error( );
+	assert( big_integer_mod_inverse_checked( &context, big_integer_create( 15 ), &result ) == BIG_INTEGER_INVALID_ARGUMENT );
+	values[2] = big_integer_create( 16 );
+	big_integer_batch_invert( &context, values, inverses, 4 );
+	assert( big_integer_last_error( ) == BIG_INTEGER_INVALID_ARGUMENT );
+	for ( i = 0; i < 4; ++i )
+		assert( inverses[i].sign == 0 );
+	big_integer_clear_error( );
+
+	context = big_integer_create_mod_context( big_integer_create( 10 ) );
+	assert( big_integer_last_error( ) == BIG_INTEGER_INVALID_ARGUMENT );
+	big_integer_clear_error( );
+	assert( big_integer_mod_multiply( &context, big_integer_create( 3 ), big_integer_create( 3 ) ).sign == 0 );
+	assert( big_integer_last_error( ) == BIG_INTEGER_INVALID_ARGUMENT );
+	big_integer_clear_error( );
+	values[2] = big_integer_create( 3 );
+	for ( i = 0; i < 4; ++i )
+		inverses[i] = big_integer_create( 1 );
+	big_integer_batch_invert( &context, values, inverses, 4 );
+	assert( big_integer_last_error( ) == BIG_INTEGER_INVALID_ARGUMENT );
+	for ( i = 0; i < 4; ++i )
+		assert( inverses[i].sign == 0 );
+	big_integer_clear_error( );
+	big_integer_create_mod_context( big_integer_create( 1 ) );
+	assert( big_integer_last_error( ) == BIG_INTEGER_INVALID_ARGUMENT );
+	big_integer_clear_error( );
+	big_integer_set_error_mode( BIG_INTEGER_ERROR_ABORT );
 };
 
 void test_performance()
@@ -456,6 +1810,25 @@ int main(int argc, const char **argv)
 	test_subtract();
 	test_increment();
 	test_decrement();
+	test_mul_ui();
+	test_divmod_ui();
+	test_divmod_divisor();
+	test_multiply();
+	test_square();
+	test_pow_ui();
+	test_is_probable_prime();
+	test_next_prime();
+	test_is_probable_prime_batch();
+	test_random();
+	test_batch();
+	test_file();
+	test_write_decimal();
+	test_shared();
+	test_double_conversion();
+	test_error_model();
+	test_counter();
+	test_async();
+	test_mod_context();
 	
 	test_performance();
 